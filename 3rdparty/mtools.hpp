@@ -10,6 +10,7 @@
 #include <iostream> // Added for cout, cerr
 #include <iomanip>  // Added for std::put_time
 #include <unordered_map>
+#include <string_view>
 #include <type_traits>
 #include <opencv2/opencv.hpp>
 #ifdef _WIN32
@@ -318,6 +319,9 @@ namespace MT{
     class OCRDictionary {
     public:
         OCRDictionary(){}
+        // 反向查找表的键指向 arena_，禁止拷贝
+        OCRDictionary(const OCRDictionary&) = delete;
+        OCRDictionary& operator=(const OCRDictionary&) = delete;
         OCRDictionary(const std::string& dict_path) {
             this->load(dict_path);
         }
@@ -337,42 +341,69 @@ namespace MT{
                 return false;
             }
             std::string line;
-            dictionary_.clear(); // Clear previous data if any
+            arena_.clear(); // Clear previous data if any
+            offsets_.assign(1, 0);
             char_to_index_.clear(); // Clear previous data if any
             while (std::getline(file, line)) {
                 // Optional: Add UTF-8 BOM removal if necessary
                 // if (line.rfind("\xEF\xBB\xBF", 0) == 0) { line.erase(0, 3); }
                 if (!line.empty()) {
-                    dictionary_.push_back(line);
-                    char_to_index_[line] = static_cast<int>(dictionary_.size() - 1);
+                    arena_ += line;
+                    offsets_.push_back(static_cast<uint32_t>(arena_.size()));
                 }
             }
             file.close();
-            // std::cout << "字典加载完成，字符数量: " << dictionary_.size() << std::endl;
+            // 字符连续存放，加载完成后再建立反向查找表，string_view 指向不再移动的 arena_
+            for (size_t i = 0; i + 1 < offsets_.size(); ++i) {
+                char_to_index_.emplace(view(i), static_cast<int>(i));
+            }
+            // std::cout << "字典加载完成，字符数量: " << size() << std::endl;
             return true;
         }
-        // 通过索引获取字符
-        std::string get_char(int index) const {
-            if (index < 0 || static_cast<size_t>(index) >= dictionary_.size()) {
+        // 通过索引获取字符，返回的视图在字典重新加载前有效
+        std::string_view get_char(int index) const {
+            if (index < 0 || static_cast<size_t>(index) >= size()) {
                 return " "; // 返回空字符串表示索引无效
             }
-            return dictionary_[static_cast<size_t>(index)];
+            return view(static_cast<size_t>(index));
         }
 
         // 通过字符获取索引
-        int get_index(const std::string& ch) const {
+        int get_index(std::string_view ch) const {
             auto it = char_to_index_.find(ch);
             if (it != char_to_index_.end()) {
                 return it->second;
             }
             return -1; // -1 表示未找到
         }
+        // 只保留 indices 列出的字符并按给出顺序重新编号，无效下标被忽略
+        void retain(const std::vector<int>& indices) {
+            std::string arena;
+            std::vector<uint32_t> offsets(1, 0);
+            for (int i : indices) {
+                if (i < 0 || static_cast<size_t>(i) >= size()) continue;
+                std::string_view ch = view(static_cast<size_t>(i));
+                arena.append(ch.data(), ch.size());
+                offsets.push_back(static_cast<uint32_t>(arena.size()));
+            }
+            arena_ = std::move(arena);
+            offsets_ = std::move(offsets);
+            char_to_index_.clear();
+            for (size_t i = 0; i + 1 < offsets_.size(); ++i) {
+                char_to_index_.emplace(view(i), static_cast<int>(i));
+            }
+        }
         // 获取字典大小
         size_t size() const {
-            return dictionary_.size();
+            return offsets_.empty() ? 0 : offsets_.size() - 1;
         }
     private:
-        std::vector<std::string> dictionary_;          // 字符列表
-        std::unordered_map<std::string, int> char_to_index_; // 反向查找表
+        std::string_view view(size_t index) const {
+            return std::string_view(arena_.data() + offsets_[index], offsets_[index + 1] - offsets_[index]);
+        }
+
+        std::string arena_;                                      // 所有字符的UTF-8编码连续存放
+        std::vector<uint32_t> offsets_;                          // 第 i 个字符为 [offsets_[i], offsets_[i+1])
+        std::unordered_map<std::string_view, int> char_to_index_; // 反向查找表
     };
 } // namespace MT
\ No newline at end of file
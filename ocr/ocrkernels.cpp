@@ -0,0 +1,477 @@
+#include "ocrkernels.h"
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+#define OCR_PACK_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+// MSVC 无需编译选项即可使用全部内建函数，按运行时检测结果分派
+#define OCR_TARGET_SSSE3
+#define OCR_TARGET_AVX2
+#else
+#define OCR_TARGET_SSSE3 __attribute__((target("ssse3")))
+#define OCR_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define OCR_PACK_NEON 1
+#endif
+
+namespace ocr {
+
+namespace {
+
+// 输入通道 k 的 x * scale[k] + bias[k] 写到输出平面 2-k
+struct PackArgs {
+    const cv::Mat* bgr;
+    float* dst_r;
+    float* dst_g;
+    float* dst_b;
+    float scale[3];
+    float bias[3];
+};
+
+inline void PackTail(const uint8_t* src, size_t off, int x, int cols, const PackArgs& a) {
+    for (; x < cols; ++x) {
+        a.dst_b[off + x] = src[3 * x + 0] * a.scale[0] + a.bias[0];
+        a.dst_g[off + x] = src[3 * x + 1] * a.scale[1] + a.bias[1];
+        a.dst_r[off + x] = src[3 * x + 2] * a.scale[2] + a.bias[2];
+    }
+}
+
+void PackScalar(const PackArgs& a) {
+    const int cols = a.bgr->cols;
+    for (int y = 0; y < a.bgr->rows; ++y) {
+        PackTail(a.bgr->ptr<uint8_t>(y), static_cast<size_t>(y) * cols, 0, cols, a);
+    }
+}
+
+#if defined(OCR_PACK_X86)
+// 48字节(16个BGR像素)拆分为 B/G/R 三个16字节向量
+OCR_TARGET_SSSE3 inline void Deinterleave16(const uint8_t* src, __m128i& b, __m128i& g, __m128i& r) {
+    const __m128i p0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    const __m128i p1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16));
+    const __m128i p2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 32));
+
+    b = _mm_or_si128(_mm_or_si128(
+            _mm_shuffle_epi8(p0, _mm_setr_epi8(0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+            _mm_shuffle_epi8(p1, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14, -1, -1, -1, -1, -1))),
+            _mm_shuffle_epi8(p2, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 1, 4, 7, 10, 13)));
+    g = _mm_or_si128(_mm_or_si128(
+            _mm_shuffle_epi8(p0, _mm_setr_epi8(1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+            _mm_shuffle_epi8(p1, _mm_setr_epi8(-1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1))),
+            _mm_shuffle_epi8(p2, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14)));
+    r = _mm_or_si128(_mm_or_si128(
+            _mm_shuffle_epi8(p0, _mm_setr_epi8(2, 5, 8, 11, 14, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+            _mm_shuffle_epi8(p1, _mm_setr_epi8(-1, -1, -1, -1, -1, 1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1))),
+            _mm_shuffle_epi8(p2, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15)));
+}
+
+OCR_TARGET_SSSE3 inline void StoreNorm16Sse(__m128i v, __m128 scale, __m128 bias, float* dst) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i lo16 = _mm_unpacklo_epi8(v, zero);
+    __m128i hi16 = _mm_unpackhi_epi8(v, zero);
+    _mm_storeu_ps(dst,      _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo16, zero)), scale), bias));
+    _mm_storeu_ps(dst + 4,  _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo16, zero)), scale), bias));
+    _mm_storeu_ps(dst + 8,  _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi16, zero)), scale), bias));
+    _mm_storeu_ps(dst + 12, _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi16, zero)), scale), bias));
+}
+
+OCR_TARGET_SSSE3 void PackSsse3(const PackArgs& a) {
+    const __m128 sb = _mm_set1_ps(a.scale[0]), bb = _mm_set1_ps(a.bias[0]);
+    const __m128 sg = _mm_set1_ps(a.scale[1]), bg = _mm_set1_ps(a.bias[1]);
+    const __m128 sr = _mm_set1_ps(a.scale[2]), br = _mm_set1_ps(a.bias[2]);
+    const int cols = a.bgr->cols;
+    for (int y = 0; y < a.bgr->rows; ++y) {
+        const uint8_t* src = a.bgr->ptr<uint8_t>(y);
+        const size_t off = static_cast<size_t>(y) * cols;
+        int x = 0;
+        for (; x + 16 <= cols; x += 16) {
+            __m128i b, g, r;
+            Deinterleave16(src + 3 * x, b, g, r);
+            StoreNorm16Sse(b, sb, bb, a.dst_b + off + x);
+            StoreNorm16Sse(g, sg, bg, a.dst_g + off + x);
+            StoreNorm16Sse(r, sr, br, a.dst_r + off + x);
+        }
+        PackTail(src, off, x, cols, a);
+    }
+}
+
+OCR_TARGET_AVX2 inline void StoreNorm16Avx2(__m128i v, __m256 scale, __m256 bias, float* dst) {
+    __m256 lo = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(v));
+    __m256 hi = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_srli_si128(v, 8)));
+    _mm256_storeu_ps(dst, _mm256_add_ps(_mm256_mul_ps(lo, scale), bias));
+    _mm256_storeu_ps(dst + 8, _mm256_add_ps(_mm256_mul_ps(hi, scale), bias));
+}
+
+OCR_TARGET_AVX2 void PackAvx2(const PackArgs& a) {
+    const __m256 sb = _mm256_set1_ps(a.scale[0]), bb = _mm256_set1_ps(a.bias[0]);
+    const __m256 sg = _mm256_set1_ps(a.scale[1]), bg = _mm256_set1_ps(a.bias[1]);
+    const __m256 sr = _mm256_set1_ps(a.scale[2]), br = _mm256_set1_ps(a.bias[2]);
+    const int cols = a.bgr->cols;
+    for (int y = 0; y < a.bgr->rows; ++y) {
+        const uint8_t* src = a.bgr->ptr<uint8_t>(y);
+        const size_t off = static_cast<size_t>(y) * cols;
+        int x = 0;
+        for (; x + 16 <= cols; x += 16) {
+            __m128i b, g, r;
+            Deinterleave16(src + 3 * x, b, g, r);
+            StoreNorm16Avx2(b, sb, bb, a.dst_b + off + x);
+            StoreNorm16Avx2(g, sg, bg, a.dst_g + off + x);
+            StoreNorm16Avx2(r, sr, br, a.dst_r + off + x);
+        }
+        PackTail(src, off, x, cols, a);
+    }
+}
+
+enum class PackLevel { Scalar, Ssse3, Avx2 };
+
+PackLevel DetectPackLevel() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4] = {0};
+    __cpuid(info, 0);
+    const int max_leaf = info[0];
+    __cpuid(info, 1);
+    const bool ssse3 = (info[2] & (1 << 9)) != 0;
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    bool avx2 = false;
+    if (max_leaf >= 7 && osxsave && avx && (_xgetbv(0) & 0x6) == 0x6) {
+        __cpuidex(info, 7, 0);
+        avx2 = (info[1] & (1 << 5)) != 0;
+    }
+#else
+    __builtin_cpu_init();
+    const bool ssse3 = __builtin_cpu_supports("ssse3");
+    const bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+    if (avx2) return PackLevel::Avx2;
+    if (ssse3) return PackLevel::Ssse3;
+    return PackLevel::Scalar;
+}
+
+PackLevel GetPackLevel() {
+    static const PackLevel level = DetectPackLevel();
+    return level;
+}
+#endif
+
+#if defined(OCR_PACK_NEON)
+inline void StoreNorm16Neon(uint8x16_t v, float32x4_t scale, float32x4_t bias, float* dst) {
+    uint16x8_t lo16 = vmovl_u8(vget_low_u8(v));
+    uint16x8_t hi16 = vmovl_u8(vget_high_u8(v));
+    vst1q_f32(dst,      vmlaq_f32(bias, vcvtq_f32_u32(vmovl_u16(vget_low_u16(lo16))), scale));
+    vst1q_f32(dst + 4,  vmlaq_f32(bias, vcvtq_f32_u32(vmovl_u16(vget_high_u16(lo16))), scale));
+    vst1q_f32(dst + 8,  vmlaq_f32(bias, vcvtq_f32_u32(vmovl_u16(vget_low_u16(hi16))), scale));
+    vst1q_f32(dst + 12, vmlaq_f32(bias, vcvtq_f32_u32(vmovl_u16(vget_high_u16(hi16))), scale));
+}
+
+void PackNeon(const PackArgs& a) {
+    const float32x4_t sb = vdupq_n_f32(a.scale[0]), bb = vdupq_n_f32(a.bias[0]);
+    const float32x4_t sg = vdupq_n_f32(a.scale[1]), bg = vdupq_n_f32(a.bias[1]);
+    const float32x4_t sr = vdupq_n_f32(a.scale[2]), br = vdupq_n_f32(a.bias[2]);
+    const int cols = a.bgr->cols;
+    for (int y = 0; y < a.bgr->rows; ++y) {
+        const uint8_t* src = a.bgr->ptr<uint8_t>(y);
+        const size_t off = static_cast<size_t>(y) * cols;
+        int x = 0;
+        for (; x + 16 <= cols; x += 16) {
+            uint8x16x3_t px = vld3q_u8(src + 3 * x);
+            StoreNorm16Neon(px.val[0], sb, bb, a.dst_b + off + x);
+            StoreNorm16Neon(px.val[1], sg, bg, a.dst_g + off + x);
+            StoreNorm16Neon(px.val[2], sr, br, a.dst_r + off + x);
+        }
+        PackTail(src, off, x, cols, a);
+    }
+}
+#endif
+
+int ArgmaxScalar(const float* data, int n, float* max_value) {
+    int best = 0;
+    float best_val = data[0];
+    for (int i = 1; i < n; ++i) {
+        if (data[i] > best_val) {
+            best_val = data[i];
+            best = i;
+        }
+    }
+    *max_value = best_val;
+    return best;
+}
+
+#if defined(OCR_PACK_X86)
+// 8路并行比较，每路记录首次出现的最大值下标，最后归约
+OCR_TARGET_AVX2 int ArgmaxAvx2(const float* data, int n, float* max_value) {
+    if (n < 16) {
+        return ArgmaxScalar(data, n, max_value);
+    }
+    __m256 best_val = _mm256_loadu_ps(data);
+    __m256i best_idx = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    __m256i idx = best_idx;
+    const __m256i step = _mm256_set1_epi32(8);
+    int i = 8;
+    for (; i + 8 <= n; i += 8) {
+        idx = _mm256_add_epi32(idx, step);
+        __m256 v = _mm256_loadu_ps(data + i);
+        __m256 gt = _mm256_cmp_ps(v, best_val, _CMP_GT_OQ);
+        best_val = _mm256_blendv_ps(best_val, v, gt);
+        best_idx = _mm256_blendv_epi8(best_idx, idx, _mm256_castps_si256(gt));
+    }
+
+    alignas(32) float vals[8];
+    alignas(32) int idxs[8];
+    _mm256_store_ps(vals, best_val);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(idxs), best_idx);
+    int best = idxs[0];
+    float best_v = vals[0];
+    for (int k = 1; k < 8; ++k) {
+        if (vals[k] > best_v || (vals[k] == best_v && idxs[k] < best)) {
+            best_v = vals[k];
+            best = idxs[k];
+        }
+    }
+    for (; i < n; ++i) {
+        if (data[i] > best_v) {
+            best_v = data[i];
+            best = i;
+        }
+    }
+    *max_value = best_v;
+    return best;
+}
+#endif
+
+#if defined(OCR_PACK_NEON)
+int ArgmaxNeon(const float* data, int n, float* max_value) {
+    if (n < 8) {
+        return ArgmaxScalar(data, n, max_value);
+    }
+    float32x4_t best_val = vld1q_f32(data);
+    const uint32_t init_idx[4] = {0, 1, 2, 3};
+    uint32x4_t best_idx = vld1q_u32(init_idx);
+    uint32x4_t idx = best_idx;
+    const uint32x4_t step = vdupq_n_u32(4);
+    int i = 4;
+    for (; i + 4 <= n; i += 4) {
+        idx = vaddq_u32(idx, step);
+        float32x4_t v = vld1q_f32(data + i);
+        uint32x4_t gt = vcgtq_f32(v, best_val);
+        best_val = vbslq_f32(gt, v, best_val);
+        best_idx = vbslq_u32(gt, idx, best_idx);
+    }
+
+    float vals[4];
+    uint32_t idxs[4];
+    vst1q_f32(vals, best_val);
+    vst1q_u32(idxs, best_idx);
+    int best = static_cast<int>(idxs[0]);
+    float best_v = vals[0];
+    for (int k = 1; k < 4; ++k) {
+        if (vals[k] > best_v || (vals[k] == best_v && static_cast<int>(idxs[k]) < best)) {
+            best_v = vals[k];
+            best = static_cast<int>(idxs[k]);
+        }
+    }
+    for (; i < n; ++i) {
+        if (data[i] > best_v) {
+            best_v = data[i];
+            best = i;
+        }
+    }
+    *max_value = best_v;
+    return best;
+}
+#endif
+
+void ThresholdScalar(const float* src, size_t n, float thresh, uint8_t* dst) {
+    for (size_t i = 0; i < n; ++i) {
+        dst[i] = src[i] > thresh ? 255 : 0;
+    }
+}
+
+#if defined(OCR_PACK_X86)
+// 每次比较32个float，比较结果(全1/全0)两次饱和打包为字节后修正跨128位通道的顺序
+OCR_TARGET_AVX2 void ThresholdAvx2(const float* src, size_t n, float thresh, uint8_t* dst) {
+    const __m256 t = _mm256_set1_ps(thresh);
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i m0 = _mm256_castps_si256(_mm256_cmp_ps(_mm256_loadu_ps(src + i), t, _CMP_GT_OQ));
+        __m256i m1 = _mm256_castps_si256(_mm256_cmp_ps(_mm256_loadu_ps(src + i + 8), t, _CMP_GT_OQ));
+        __m256i m2 = _mm256_castps_si256(_mm256_cmp_ps(_mm256_loadu_ps(src + i + 16), t, _CMP_GT_OQ));
+        __m256i m3 = _mm256_castps_si256(_mm256_cmp_ps(_mm256_loadu_ps(src + i + 24), t, _CMP_GT_OQ));
+        __m256i w01 = _mm256_packs_epi32(m0, m1);
+        __m256i w23 = _mm256_packs_epi32(m2, m3);
+        __m256i bytes = _mm256_packs_epi16(w01, w23);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_permutevar8x32_epi32(bytes, order));
+    }
+    ThresholdScalar(src + i, n - i, thresh, dst + i);
+}
+#endif
+
+#if defined(OCR_PACK_NEON)
+void ThresholdNeon(const float* src, size_t n, float thresh, uint8_t* dst) {
+    const float32x4_t t = vdupq_n_f32(thresh);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        uint16x4_t m0 = vmovn_u32(vcgtq_f32(vld1q_f32(src + i), t));
+        uint16x4_t m1 = vmovn_u32(vcgtq_f32(vld1q_f32(src + i + 4), t));
+        uint16x4_t m2 = vmovn_u32(vcgtq_f32(vld1q_f32(src + i + 8), t));
+        uint16x4_t m3 = vmovn_u32(vcgtq_f32(vld1q_f32(src + i + 12), t));
+        uint8x8_t lo = vmovn_u16(vcombine_u16(m0, m1));
+        uint8x8_t hi = vmovn_u16(vcombine_u16(m2, m3));
+        vst1q_u8(dst + i, vcombine_u8(lo, hi));
+    }
+    ThresholdScalar(src + i, n - i, thresh, dst + i);
+}
+#endif
+
+} // namespace
+
+void PackBgrToNchw(const cv::Mat& bgr, float* dst, const NormParams& norm) {
+    CV_Assert(bgr.type() == CV_8UC3);
+    const size_t plane = static_cast<size_t>(bgr.rows) * bgr.cols;
+
+    // (x/255 - mean) / std 合并为 x * scale + bias
+    PackArgs args;
+    args.bgr = &bgr;
+    args.dst_r = dst;
+    args.dst_g = dst + plane;
+    args.dst_b = dst + 2 * plane;
+    for (int k = 0; k < 3; ++k) {
+        args.scale[k] = 1.0f / (255.0f * norm.std[k]);
+        args.bias[k] = -norm.mean[k] / norm.std[k];
+    }
+
+#if defined(OCR_PACK_X86)
+    switch (GetPackLevel()) {
+    case PackLevel::Avx2:  PackAvx2(args); return;
+    case PackLevel::Ssse3: PackSsse3(args); return;
+    default: break;
+    }
+#elif defined(OCR_PACK_NEON)
+    PackNeon(args);
+    return;
+#endif
+    PackScalar(args);
+}
+
+void ResizePadToNchw(const cv::Mat& bgr, const cv::Rect2f& roi, cv::Size slot, bool rotate180,
+                     float* dst, const NormParams& norm) {
+    CV_Assert(bgr.empty() || bgr.type() == CV_8UC3);
+    const int slot_w = slot.width;
+    const int slot_h = slot.height;
+    const size_t plane = static_cast<size_t>(slot_w) * slot_h;
+
+    float scale[3], bias[3];
+    for (int k = 0; k < 3; ++k) {
+        scale[k] = 1.0f / (255.0f * norm.std[k]);
+        bias[k] = -norm.mean[k] / norm.std[k];
+    }
+    // 输入通道 k 写到输出平面 2-k，先整体填充114
+    float* planes[3] = {dst + 2 * plane, dst + plane, dst};
+    for (int k = 0; k < 3; ++k) {
+        std::fill(planes[k], planes[k] + plane, 114.0f * scale[k] + bias[k]);
+    }
+    if (bgr.empty() || roi.width <= 0.0f || roi.height <= 0.0f) {
+        return;
+    }
+
+    // PaddingImg 的等比缩放与居中
+    const float r = (std::min)(slot_w / roi.width, slot_h / roi.height);
+    const int content_w = (std::min)(static_cast<int>(roi.width * r), slot_w);
+    const int content_h = (std::min)(static_cast<int>(roi.height * r), slot_h);
+    if (content_w <= 0 || content_h <= 0) {
+        return;
+    }
+    const int top = (slot_h - content_h) / 2;
+    const int left = (slot_w - content_w) / 2;
+
+    // 按 cv::resize 的像素中心对齐计算源坐标，越界钳位到边缘
+    const float step_x = roi.width / content_w;
+    const float step_y = roi.height / content_h;
+    const int max_x = bgr.cols - 1;
+    const int max_y = bgr.rows - 1;
+    std::vector<int> x0(content_w), x1(content_w);
+    std::vector<float> fx(content_w);
+    for (int cx = 0; cx < content_w; ++cx) {
+        float x = roi.x + (cx + 0.5f) * step_x - 0.5f;
+        x = (std::min)((std::max)(x, 0.0f), static_cast<float>(max_x));
+        const int xi = static_cast<int>(x);
+        x0[cx] = xi * 3;
+        x1[cx] = (std::min)(xi + 1, max_x) * 3;
+        fx[cx] = x - xi;
+    }
+
+    for (int cy = 0; cy < content_h; ++cy) {
+        float y = roi.y + (cy + 0.5f) * step_y - 0.5f;
+        y = (std::min)((std::max)(y, 0.0f), static_cast<float>(max_y));
+        const int yi = static_cast<int>(y);
+        const float fy = y - yi;
+        const uint8_t* row0 = bgr.ptr<uint8_t>(yi);
+        const uint8_t* row1 = bgr.ptr<uint8_t>((std::min)(yi + 1, max_y));
+
+        // 旋转180度即输出坐标整体翻转
+        const int oy = rotate180 ? slot_h - 1 - top - cy : top + cy;
+        const int ox = rotate180 ? slot_w - 1 - left : left;
+        const int dx = rotate180 ? -1 : 1;
+        const size_t row_offset = static_cast<size_t>(oy) * slot_w;
+        for (int cx = 0; cx < content_w; ++cx) {
+            const float wx = fx[cx];
+            const size_t out = row_offset + ox + dx * cx;
+            for (int k = 0; k < 3; ++k) {
+                const float top_v = row0[x0[cx] + k] + (row0[x1[cx] + k] - row0[x0[cx] + k]) * wx;
+                const float bottom_v = row1[x0[cx] + k] + (row1[x1[cx] + k] - row1[x0[cx] + k]) * wx;
+                planes[k][out] = (top_v + (bottom_v - top_v) * fy) * scale[k] + bias[k];
+            }
+        }
+    }
+}
+
+int ArgmaxF32(const float* data, int n, float* max_value) {
+    if (n <= 0) {
+        return -1;
+    }
+#if defined(OCR_PACK_X86)
+    if (GetPackLevel() == PackLevel::Avx2) {
+        return ArgmaxAvx2(data, n, max_value);
+    }
+#elif defined(OCR_PACK_NEON)
+    return ArgmaxNeon(data, n, max_value);
+#endif
+    return ArgmaxScalar(data, n, max_value);
+}
+
+void ThresholdToU8(const float* src, size_t n, float thresh, uint8_t* dst) {
+#if defined(OCR_PACK_X86)
+    if (GetPackLevel() == PackLevel::Avx2) {
+        ThresholdAvx2(src, n, thresh, dst);
+        return;
+    }
+#elif defined(OCR_PACK_NEON)
+    ThresholdNeon(src, n, thresh, dst);
+    return;
+#endif
+    ThresholdScalar(src, n, thresh, dst);
+}
+
+const char* PackKernelName() {
+#if defined(OCR_PACK_X86)
+    switch (GetPackLevel()) {
+    case PackLevel::Avx2:  return "AVX2";
+    case PackLevel::Ssse3: return "SSSE3";
+    default: return "scalar";
+    }
+#elif defined(OCR_PACK_NEON)
+    return "NEON";
+#else
+    return "scalar";
+#endif
+}
+
+} // namespace ocr
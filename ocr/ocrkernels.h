@@ -0,0 +1,42 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <opencv2/core/mat.hpp>
+
+namespace ocr {
+
+// 归一化参数，按输入图像通道(B,G,R)顺序给出，与 convertTo/subtract/divide 的写法一致
+struct NormParams {
+    float mean[3];
+    float std[3];
+};
+
+// det 模型 ImageNet 归一化，cls/rec 模型 (x - 0.5) / 0.5
+constexpr NormParams kDetNorm{{0.485f, 0.456f, 0.406f}, {0.229f, 0.224f, 0.225f}};
+constexpr NormParams kClsRecNorm{{0.5f, 0.5f, 0.5f}, {0.5f, 0.5f, 0.5f}};
+
+// 单遍完成 BGR8 -> 归一化 -> RB交换 -> NCHW 打包
+// 等价于 convertTo(1/255) + subtract(mean) + divide(std) + blobFromImage(swapRB=true)，
+// 但只读一遍 uint8 图像，直接写入调用方预分配的 3*rows*cols 个 float。
+// x86 下运行时按CPU支持选择 AVX2 / SSSE3 实现，ARM 下使用 NEON，否则使用标量实现。
+void PackBgrToNchw(const cv::Mat& bgr, float* dst, const NormParams& norm);
+
+// 从 bgr 的 roi 区域双线性采样，一次写入 slot 大小的归一化 NCHW 张量槽位
+// 缩放与居中规则同 MT::PaddingImg(等比缩放后四周填充114)，结果等价于
+// 裁剪 -> PaddingImg -> [旋转180度] -> PackBgrToNchw，但不产生中间图像。
+// roi 超出图像的部分按边缘像素复制，与 getRectSubPix 一致。
+void ResizePadToNchw(const cv::Mat& bgr, const cv::Rect2f& roi, cv::Size slot, bool rotate180,
+                     float* dst, const NormParams& norm);
+
+// 求 data[0..n) 的最大值及其下标（多个最大值时取最小下标），n 为 0 时返回 -1
+// 用于 CTC 贪心解码沿类别轴取 argmax，实现选择与 PackBgrToNchw 相同
+int ArgmaxF32(const float* data, int n, float* max_value);
+
+// 二值化 src[0..n)：大于 thresh 写 255，否则写 0，与 cv::threshold(THRESH_BINARY) 一致，
+// 直接得到 findContours 所需的 uint8 图，省去 float 二值图和 convertTo 两遍
+void ThresholdToU8(const float* src, size_t n, float thresh, uint8_t* dst);
+
+// 当前使用的打包实现名称，用于日志
+const char* PackKernelName();
+
+} // namespace ocr
@@ -0,0 +1,425 @@
+#include "onnxprune.h"
+#include <cstdint>
+#include <cstring>
+#include <set>
+#include <string_view>
+
+namespace ocr {
+
+namespace {
+
+// ONNX 字段编号（onnx.proto）
+enum : uint32_t {
+    kModelOpset = 8, kModelGraph = 7,
+    kOpsetDomain = 1, kOpsetVersion = 2,
+    kGraphNode = 1, kGraphInitializer = 5, kGraphInput = 11, kGraphOutput = 12, kGraphValueInfo = 13,
+    kNodeInput = 1, kNodeOutput = 2, kNodeOpType = 4, kNodeAttribute = 5,
+    kAttrName = 1, kAttrInt = 3,
+    kTensorDims = 1, kTensorDataType = 2, kTensorFloatData = 4, kTensorName = 8, kTensorRawData = 9,
+    kTensorDataLocation = 14,
+    kValueInfoName = 1, kValueInfoType = 2,
+    kTypeTensor = 1, kTypeTensorShape = 2, kShapeDim = 1, kDimValue = 1,
+};
+constexpr int kOnnxFloat = 1;
+
+// protobuf 线格式的一个字段
+struct PbField {
+    uint32_t number = 0;
+    uint32_t wire = 0;
+    uint64_t varint = 0;        // wire 0
+    std::string_view payload;   // wire 1/2/5 的内容
+    std::string_view raw;       // 含 tag 的完整编码，未改动时原样拷贝
+};
+
+bool ReadVarint(std::string_view buf, size_t& pos, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (pos >= buf.size()) return false;
+        const uint8_t byte = static_cast<uint8_t>(buf[pos++]);
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+bool ParseFields(std::string_view buf, std::vector<PbField>& fields) {
+    fields.clear();
+    size_t pos = 0;
+    while (pos < buf.size()) {
+        const size_t start = pos;
+        uint64_t key = 0;
+        if (!ReadVarint(buf, pos, key)) return false;
+        PbField f;
+        f.number = static_cast<uint32_t>(key >> 3);
+        f.wire = static_cast<uint32_t>(key & 7);
+        switch (f.wire) {
+        case 0:
+            if (!ReadVarint(buf, pos, f.varint)) return false;
+            break;
+        case 1:
+        case 5: {
+            const size_t len = f.wire == 1 ? 8 : 4;
+            if (buf.size() - pos < len) return false;
+            f.payload = buf.substr(pos, len);
+            pos += len;
+            break;
+        }
+        case 2: {
+            uint64_t len = 0;
+            if (!ReadVarint(buf, pos, len) || len > buf.size() - pos) return false;
+            f.payload = buf.substr(pos, static_cast<size_t>(len));
+            pos += static_cast<size_t>(len);
+            break;
+        }
+        default:
+            return false;   // ONNX 不使用 group
+        }
+        f.raw = buf.substr(start, pos - start);
+        fields.push_back(f);
+    }
+    return true;
+}
+
+void WriteVarint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+void WriteVarintField(std::string& out, uint32_t number, uint64_t value) {
+    WriteVarint(out, (static_cast<uint64_t>(number) << 3) | 0);
+    WriteVarint(out, value);
+}
+
+void WriteBytesField(std::string& out, uint32_t number, std::string_view payload) {
+    WriteVarint(out, (static_cast<uint64_t>(number) << 3) | 2);
+    WriteVarint(out, payload.size());
+    out.append(payload.data(), payload.size());
+}
+
+// 读取字段 number 的第一个字符串值
+std::string GetString(std::string_view msg, uint32_t number) {
+    std::vector<PbField> fields;
+    if (!ParseFields(msg, fields)) return std::string();
+    for (const auto& f : fields) {
+        if (f.number == number && f.wire == 2) return std::string(f.payload);
+    }
+    return std::string();
+}
+
+struct NodeInfo {
+    std::string op_type;
+    std::vector<std::string> inputs;
+    std::vector<std::string> outputs;
+    bool has_axis = false;
+    int64_t axis = 0;
+};
+
+bool ParseNode(std::string_view msg, NodeInfo& node) {
+    std::vector<PbField> fields;
+    if (!ParseFields(msg, fields)) return false;
+    for (const auto& f : fields) {
+        if (f.wire != 2) continue;
+        if (f.number == kNodeInput) node.inputs.emplace_back(f.payload);
+        else if (f.number == kNodeOutput) node.outputs.emplace_back(f.payload);
+        else if (f.number == kNodeOpType) node.op_type.assign(f.payload);
+        else if (f.number == kNodeAttribute) {
+            std::vector<PbField> attr;
+            if (!ParseFields(f.payload, attr)) return false;
+            std::string_view name;
+            const PbField* value = nullptr;
+            for (const auto& a : attr) {
+                if (a.number == kAttrName && a.wire == 2) name = a.payload;
+                else if (a.number == kAttrInt && a.wire == 0) value = &a;
+            }
+            if (name == "axis" && value) {
+                node.has_axis = true;
+                node.axis = static_cast<int64_t>(value->varint);
+            }
+        }
+    }
+    return true;
+}
+
+struct TensorInfo {
+    std::string name;
+    std::vector<int64_t> dims;
+    int data_type = 0;
+    bool external = false;
+    std::vector<float> values;
+};
+
+bool ParseTensor(std::string_view msg, TensorInfo& tensor) {
+    std::vector<PbField> fields;
+    if (!ParseFields(msg, fields)) return false;
+    for (const auto& f : fields) {
+        if (f.number == kTensorDims) {
+            if (f.wire == 0) {
+                tensor.dims.push_back(static_cast<int64_t>(f.varint));
+            } else if (f.wire == 2) {
+                size_t pos = 0;
+                uint64_t v = 0;
+                while (pos < f.payload.size()) {
+                    if (!ReadVarint(f.payload, pos, v)) return false;
+                    tensor.dims.push_back(static_cast<int64_t>(v));
+                }
+            }
+        } else if (f.number == kTensorDataType && f.wire == 0) {
+            tensor.data_type = static_cast<int>(f.varint);
+        } else if (f.number == kTensorName && f.wire == 2) {
+            tensor.name.assign(f.payload);
+        } else if (f.number == kTensorDataLocation && f.wire == 0) {
+            tensor.external = f.varint == 1;
+        } else if ((f.number == kTensorRawData && f.wire == 2) ||
+                   (f.number == kTensorFloatData && (f.wire == 2 || f.wire == 5))) {
+            // raw_data 与 packed float_data 都是小端 float 序列
+            const size_t count = f.payload.size() / sizeof(float);
+            const size_t old = tensor.values.size();
+            tensor.values.resize(old + count);
+            std::memcpy(tensor.values.data() + old, f.payload.data(), count * sizeof(float));
+        }
+    }
+    return true;
+}
+
+// 重写张量：只替换 dims 与数据，其余字段原样保留
+std::string RewriteTensor(std::string_view msg, const std::vector<int64_t>& dims, const std::vector<float>& values) {
+    std::vector<PbField> fields;
+    ParseFields(msg, fields);
+    std::string out;
+    out.reserve(values.size() * sizeof(float) + 256);
+    for (const auto& f : fields) {
+        if (f.number == kTensorDims || f.number == kTensorFloatData || f.number == kTensorRawData) continue;
+        out.append(f.raw.data(), f.raw.size());
+    }
+    for (int64_t d : dims) {
+        WriteVarintField(out, kTensorDims, static_cast<uint64_t>(d));
+    }
+    WriteBytesField(out, kTensorRawData,
+                    std::string_view(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(float)));
+    return out;
+}
+
+// 对消息中编号为 number 的子消息逐个调用 fn 改写，其余字段原样保留
+template <typename Fn>
+std::string RewriteSubMessages(std::string_view msg, uint32_t number, Fn&& fn) {
+    std::vector<PbField> fields;
+    ParseFields(msg, fields);
+    std::string out;
+    out.reserve(msg.size());
+    for (const auto& f : fields) {
+        if (f.number == number && f.wire == 2) {
+            WriteBytesField(out, number, fn(f.payload));
+        } else {
+            out.append(f.raw.data(), f.raw.size());
+        }
+    }
+    return out;
+}
+
+// ValueInfoProto 形状的最后一维改为 dim，没有形状信息时保持不变
+std::string RewriteLastDim(std::string_view value_info, int64_t dim) {
+    return RewriteSubMessages(value_info, kValueInfoType, [&](std::string_view type) {
+        return RewriteSubMessages(type, kTypeTensor, [&](std::string_view tensor_type) {
+            return RewriteSubMessages(tensor_type, kTypeTensorShape, [&](std::string_view shape) {
+                std::vector<PbField> fields;
+                ParseFields(shape, fields);
+                size_t last = fields.size();
+                for (size_t i = 0; i < fields.size(); ++i) {
+                    if (fields[i].number == kShapeDim) last = i;
+                }
+                std::string out;
+                for (size_t i = 0; i < fields.size(); ++i) {
+                    if (i == last) {
+                        std::string d;
+                        WriteVarintField(d, kDimValue, static_cast<uint64_t>(dim));
+                        WriteBytesField(out, kShapeDim, d);
+                    } else {
+                        out.append(fields[i].raw.data(), fields[i].raw.size());
+                    }
+                }
+                return out;
+            });
+        });
+    });
+}
+
+} // namespace
+
+std::string PruneRecHead(const std::string& model, const std::vector<int>& keep_classes, std::string* error) {
+    auto fail = [&](const char* reason) {
+        if (error) *error = reason;
+        return std::string();
+    };
+    if (keep_classes.empty()) return fail("保留类别为空");
+
+    std::vector<PbField> model_fields;
+    if (!ParseFields(model, model_fields)) return fail("模型文件解析失败");
+    std::string_view graph;
+    int64_t opset = 0;
+    for (const auto& f : model_fields) {
+        if (f.number == kModelGraph && f.wire == 2) {
+            graph = f.payload;
+        } else if (f.number == kModelOpset && f.wire == 2) {
+            std::vector<PbField> op;
+            if (!ParseFields(f.payload, op)) continue;
+            std::string_view domain;
+            int64_t version = 0;
+            for (const auto& o : op) {
+                if (o.number == kOpsetDomain && o.wire == 2) domain = o.payload;
+                else if (o.number == kOpsetVersion && o.wire == 0) version = static_cast<int64_t>(o.varint);
+            }
+            if (domain.empty() || domain == "ai.onnx") opset = version;
+        }
+    }
+    if (graph.empty()) return fail("模型中没有计算图");
+
+    std::vector<PbField> graph_fields;
+    if (!ParseFields(graph, graph_fields)) return fail("计算图解析失败");
+    std::vector<NodeInfo> nodes;
+    std::set<std::string> graph_outputs;
+    for (const auto& f : graph_fields) {
+        if (f.wire != 2) continue;
+        if (f.number == kGraphNode) {
+            NodeInfo node;
+            if (!ParseNode(f.payload, node)) return fail("节点解析失败");
+            nodes.push_back(std::move(node));
+        } else if (f.number == kGraphOutput) {
+            graph_outputs.insert(GetString(f.payload, kValueInfoName));
+        }
+    }
+
+    auto producer = [&](const std::string& name) -> const NodeInfo* {
+        for (const auto& n : nodes) {
+            for (const auto& o : n.outputs) {
+                if (o == name) return &n;
+            }
+        }
+        return nullptr;
+    };
+    auto consumers = [&](const std::string& name) {
+        int count = 0;
+        for (const auto& n : nodes) {
+            for (const auto& i : n.inputs) count += (i == name);
+        }
+        return count;
+    };
+
+    // 定位输出头 Softmax，opset 13 之前 axis 默认 1 且会展平后续维度，只接受显式的最后一维
+    const NodeInfo* softmax = nullptr;
+    for (const auto& n : nodes) {
+        if (n.op_type == "Softmax" && n.outputs.size() == 1 && graph_outputs.count(n.outputs[0])) {
+            softmax = &n;
+            break;
+        }
+    }
+    if (!softmax || softmax->inputs.size() != 1) return fail("未找到输出Softmax");
+    const bool last_axis = softmax->has_axis ? (softmax->axis == -1 || softmax->axis == 2) : opset >= 13;
+    if (!last_axis) return fail("Softmax不在类别维上");
+
+    const NodeInfo* add = nullptr;
+    const NodeInfo* matmul = producer(softmax->inputs[0]);
+    std::string bias_name;
+    if (matmul && matmul->op_type == "Add" && matmul->inputs.size() == 2) {
+        add = matmul;
+        const NodeInfo* lhs = producer(add->inputs[0]);
+        const NodeInfo* rhs = producer(add->inputs[1]);
+        if (lhs && lhs->op_type == "MatMul" && !rhs) {
+            matmul = lhs;
+            bias_name = add->inputs[1];
+        } else if (rhs && rhs->op_type == "MatMul" && !lhs) {
+            matmul = rhs;
+            bias_name = add->inputs[0];
+        } else {
+            return fail("Softmax前的Add不是MatMul+偏置");
+        }
+    }
+    if (!matmul || matmul->op_type != "MatMul" || matmul->inputs.size() != 2) return fail("Softmax前没有MatMul");
+    const std::string weight_name = matmul->inputs[1];
+    if (producer(weight_name) || consumers(weight_name) != 1) return fail("投影权重不是独占的初始化器");
+    if (add && consumers(bias_name) != 1) return fail("偏置不是独占的初始化器");
+    if (consumers(matmul->outputs[0]) != 1 || (add && consumers(add->outputs[0]) != 1)) {
+        return fail("输出头中间结果被其他节点使用");
+    }
+
+    TensorInfo weight, bias;
+    for (const auto& f : graph_fields) {
+        if (f.number != kGraphInitializer || f.wire != 2) continue;
+        const std::string name = GetString(f.payload, kTensorName);
+        if (name == weight_name && !ParseTensor(f.payload, weight)) return fail("权重解析失败");
+        if (add && name == bias_name && !ParseTensor(f.payload, bias)) return fail("偏置解析失败");
+    }
+    if (weight.name.empty() || weight.external || weight.data_type != kOnnxFloat || weight.dims.size() != 2) {
+        return fail("权重不是内嵌的二维float张量");
+    }
+    const int64_t in_dim = weight.dims[0];
+    const int64_t num_classes = weight.dims[1];
+    if (static_cast<int64_t>(weight.values.size()) != in_dim * num_classes) return fail("权重数据长度不匹配");
+    if (add && (bias.name.empty() || bias.external || bias.data_type != kOnnxFloat ||
+                bias.dims.size() != 1 || bias.dims[0] != num_classes ||
+                static_cast<int64_t>(bias.values.size()) != num_classes)) {
+        return fail("偏置不是与类别数一致的float向量");
+    }
+    for (int c : keep_classes) {
+        if (c < 0 || c >= num_classes) return fail("保留类别超出模型类别数");
+    }
+
+    // 按列抽取保留类别
+    const int64_t kept = static_cast<int64_t>(keep_classes.size());
+    std::vector<float> new_weight(static_cast<size_t>(in_dim * kept));
+    for (int64_t k = 0; k < in_dim; ++k) {
+        const float* src = weight.values.data() + k * num_classes;
+        float* dst = new_weight.data() + k * kept;
+        for (int64_t j = 0; j < kept; ++j) dst[j] = src[keep_classes[j]];
+    }
+    std::vector<float> new_bias;
+    if (add) {
+        new_bias.resize(static_cast<size_t>(kept));
+        for (int64_t j = 0; j < kept; ++j) new_bias[j] = bias.values[keep_classes[j]];
+    }
+
+    // 头部中间结果的 value_info 形状已失效，直接删除交由运行时推断
+    std::set<std::string> stale{matmul->outputs[0], softmax->outputs[0]};
+    if (add) stale.insert(add->outputs[0]);
+
+    std::string new_graph;
+    new_graph.reserve(graph.size());
+    for (const auto& f : graph_fields) {
+        if (f.wire == 2 && f.number == kGraphInitializer) {
+            const std::string name = GetString(f.payload, kTensorName);
+            if (name == weight_name) {
+                WriteBytesField(new_graph, f.number, RewriteTensor(f.payload, {in_dim, kept}, new_weight));
+                continue;
+            }
+            if (add && name == bias_name) {
+                WriteBytesField(new_graph, f.number, RewriteTensor(f.payload, {kept}, new_bias));
+                continue;
+            }
+        } else if (f.wire == 2 && f.number == kGraphValueInfo) {
+            if (stale.count(GetString(f.payload, kValueInfoName))) continue;
+        } else if (f.wire == 2 && (f.number == kGraphOutput || f.number == kGraphInput)) {
+            // 旧版本模型会把初始化器也列为图输入，形状一并修改
+            const std::string name = GetString(f.payload, kValueInfoName);
+            if (name == softmax->outputs[0] || name == weight_name || (add && name == bias_name)) {
+                WriteBytesField(new_graph, f.number, RewriteLastDim(f.payload, kept));
+                continue;
+            }
+        }
+        new_graph.append(f.raw.data(), f.raw.size());
+    }
+
+    std::string out;
+    out.reserve(model.size());
+    for (const auto& f : model_fields) {
+        if (f.number == kModelGraph && f.wire == 2) {
+            WriteBytesField(out, f.number, new_graph);
+        } else {
+            out.append(f.raw.data(), f.raw.size());
+        }
+    }
+    return out;
+}
+
+} // namespace ocr
@@ -0,0 +1,14 @@
+#pragma once
+#include <string>
+#include <vector>
+
+namespace ocr {
+
+// 裁剪 CTC 识别模型的输出头，只保留 keep_classes 列出的类别（按给出顺序重新编号）
+// 匹配 MatMul(x, W[K,C]) [-> Add(b[C])] -> Softmax(最后一维) -> 图输出 的结构，
+// W/b 须为模型内嵌的 float 初始化器且只被该头部使用。
+// 直接在 protobuf 编码上改写，不依赖 onnx 库；成功返回新模型字节，
+// 结构不匹配时返回空字符串，原因写入 error。
+std::string PruneRecHead(const std::string& model, const std::vector<int>& keep_classes, std::string* error);
+
+} // namespace ocr
@@ -1,13 +1,22 @@
 #include "paddleocr.h"
+#include "ocrkernels.h"
+#include "onnxprune.h"
+#include "yolo/result.hpp"
+#include "yolo/infer/ort_backend.hpp"
 #include <tbb/tbb.h> 
 #include <mutex>
 #include <algorithm>
+#include <iterator>
+#include <set>
 std::mutex print_mutex;
 PaddleOCR::PaddleOCR() {
     memory_info = new Ort::MemoryInfo(Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault));
 }
 
 PaddleOCR::~PaddleOCR() {
+    // 上下文中的绑定和复用张量先于会话释放
+    idle_contexts.clear();
+
     delete session_det;
     delete session_cls;
     delete session_rec;
@@ -22,12 +31,8 @@ PaddleOCR::~PaddleOCR() {
     options_cls = nullptr;
     options_rec = nullptr;
 
-    delete env_det;
-    delete env_cls;
-    delete env_rec;
-    env_det = nullptr;
-    env_cls = nullptr;
-    env_rec = nullptr;
+    env.reset();
+    tbb_limit.reset();
     
     delete memory_info;
     memory_info = nullptr;
@@ -146,7 +151,137 @@ void PaddleOCR::load_onnx_info(Ort::Session* session, std::vector<yo::Node>& inp
 }
 
 
-std::variant<bool, std::string> PaddleOCR::initialize(const std::vector<std::string>& onnx_paths, bool is_cuda) {
+void PaddleOCR::init_bound_session(BoundSession& io, Ort::Session* session,
+                                   const std::vector<yo::Node>& input, const std::vector<yo::Node>& output) {
+    io.session = session;
+    io.input_names.clear();
+    io.output_names.clear();
+    for (const auto& node : input) io.input_names.push_back(node.name);
+    for (const auto& node : output) io.output_names.push_back(node.name);
+    io.binding = std::make_unique<Ort::IoBinding>(*session);
+    io.index.clear();
+    io.lru.clear();
+}
+
+// 取一个空闲上下文，没有时新建并绑定到共享会话
+std::unique_ptr<PaddleOCR::Context> PaddleOCR::acquire_context() {
+    {
+        std::lock_guard<std::mutex> lock(context_mutex);
+        if (!idle_contexts.empty()) {
+            std::unique_ptr<Context> ctx = std::move(idle_contexts.back());
+            idle_contexts.pop_back();
+            return ctx;
+        }
+    }
+    auto ctx = std::make_unique<Context>();
+    init_bound_session(ctx->io_det, session_det, input_nodes_det, output_nodes_det);
+    init_bound_session(ctx->io_cls, session_cls, input_nodes_cls, output_nodes_cls);
+    init_bound_session(ctx->io_rec, session_rec, input_nodes_rec, output_nodes_rec);
+    return ctx;
+}
+
+void PaddleOCR::release_context(std::unique_ptr<Context> ctx) {
+    if (!ctx) return;
+    ctx->ori_img = nullptr;
+    ctx->polygons.clear();
+    std::lock_guard<std::mutex> lock(context_mutex);
+    idle_contexts.push_back(std::move(ctx));
+}
+
+// 获取指定形状的输入缓冲，调用方直接写入数据
+float* PaddleOCR::acquire_input(BoundSession& io, const std::vector<int64_t>& shape) {
+    auto it = io.index.find(shape);
+    if (it != io.index.end()) {
+        io.lru.splice(io.lru.begin(), io.lru, it->second);
+        return io.lru.front().inputs.buffers[0].data();
+    }
+
+    if (io.lru.size() >= kMaxPooledShapes) {
+        // 绑定可能仍引用被淘汰的缓冲，先解除
+        io.binding->ClearBoundInputs();
+        io.binding->ClearBoundOutputs();
+        io.index.erase(io.lru.back().shape);
+        io.lru.pop_back();
+    }
+    size_t count = 1;
+    for (int64_t d : shape) count *= static_cast<size_t>(d);
+    PooledShape entry;
+    entry.shape = shape;
+    entry.inputs.buffers.emplace_back(count);
+    entry.inputs.values.push_back(Ort::Value::CreateTensor<float>(
+        *memory_info, entry.inputs.buffers[0].data(), count, shape.data(), shape.size()));
+    io.lru.push_front(std::move(entry));
+    io.index.emplace(shape, io.lru.begin());
+    return io.lru.front().inputs.buffers[0].data();
+}
+
+// 以 acquire_input 写好的输入推理，返回复用的输出张量
+std::vector<Ort::Value>* PaddleOCR::run_bound(BoundSession& io, const std::vector<int64_t>& shape) {
+    auto it = io.index.find(shape);
+    if (it == io.index.end() || io.input_names.empty() || io.output_names.empty()) {
+        return nullptr;
+    }
+    PooledShape& entry = *it->second;
+
+    io.binding->ClearBoundInputs();
+    io.binding->ClearBoundOutputs();
+    io.binding->BindInput(io.input_names[0], entry.inputs.values[0]);
+
+    if (!entry.outputs.values.empty()) {
+        for (size_t i = 0; i < io.output_names.size(); ++i) {
+            io.binding->BindOutput(io.output_names[i], entry.outputs.values[i]);
+        }
+        io.session->Run(Ort::RunOptions{nullptr}, *io.binding);
+        return &entry.outputs.values;
+    }
+
+    // 首次遇到该形状：由 ONNX Runtime 分配输出，记录形状后建立复用缓冲
+    for (const char* name : io.output_names) {
+        io.binding->BindOutput(name, *memory_info);
+    }
+    io.session->Run(Ort::RunOptions{nullptr}, *io.binding);
+    std::vector<Ort::Value> produced = io.binding->GetOutputValues();
+
+    // 复用缓冲与后处理都按 float 读取，其它类型的输出直接拒绝
+    for (auto& value : produced) {
+        if (value.GetTensorTypeAndShapeInfo().GetElementType() != ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT) {
+            std::cerr << "run_bound: output tensor must be float32." << std::endl;
+            return nullptr;
+        }
+    }
+
+    TensorSet set;
+    set.buffers.reserve(produced.size());
+    for (auto& value : produced) {
+        auto info = value.GetTensorTypeAndShapeInfo();
+        std::vector<int64_t> out_shape = info.GetShape();
+        const float* data = value.GetTensorData<float>();
+        set.buffers.emplace_back(data, data + info.GetElementCount());
+        set.values.push_back(Ort::Value::CreateTensor<float>(
+            *memory_info, set.buffers.back().data(), set.buffers.back().size(), out_shape.data(), out_shape.size()));
+    }
+    entry.outputs = std::move(set);
+    return &entry.outputs.values;
+}
+
+// 按线程配置设置会话选项
+static void apply_thread_params(Ort::SessionOptions& options, const PaddleOCR::ThreadParams& threads, int intra) {
+    if (threads.global_pool) {
+        options.DisablePerSessionThreads();
+    } else {
+        options.SetIntraOpNumThreads((std::max)(0, intra));
+        options.SetInterOpNumThreads((std::max)(0, threads.inter));
+        options.AddConfigEntry("session.intra_op.allow_spinning", threads.allow_spinning ? "1" : "0");
+        options.AddConfigEntry("session.inter_op.allow_spinning", threads.allow_spinning ? "1" : "0");
+    }
+    if (threads.inter > 1) {
+        options.SetExecutionMode(ExecutionMode::ORT_PARALLEL);
+    }
+    options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_EXTENDED);
+}
+
+std::variant<bool, std::string> PaddleOCR::initialize(const std::vector<std::string>& onnx_paths, bool is_cuda,
+                                                      const ThreadParams& threads) {
     assert(onnx_paths.size() == 3);
 
     for (size_t i = 0; i < onnx_paths.size(); ++i) {
@@ -158,22 +293,33 @@ std::variant<bool, std::string> PaddleOCR::initialize(const std::vector<std::str
     }
 
     try {
-        env_det = new Ort::Env(ORT_LOGGING_LEVEL_WARNING, "ocr_det_env");
-        env_cls = new Ort::Env(ORT_LOGGING_LEVEL_WARNING, "ocr_cls_env");
-        env_rec = new Ort::Env(ORT_LOGGING_LEVEL_WARNING, "ocr_rec_env");
+        // ONNX Runtime 每个进程只允许一个 Env，与检测 CPU 后端共用；首个创建者的线程配置决定全局线程池，
+        // Env 已存在且不带全局线程池时退回各会话独立线程池，否则 DisablePerSessionThreads 的会话无法创建
+        ThreadParams session_threads = threads;
+        bool has_global_pool = false;
+        if (threads.global_pool) {
+            deploy::OrtGlobalThreadPool global_pool;
+            global_pool.intra_threads = threads.global_intra;
+            global_pool.inter_threads = threads.inter;
+            global_pool.allow_spinning = threads.allow_spinning;
+            env = deploy::acquireOrtEnv(&global_pool, &has_global_pool);
+        } else {
+            env = deploy::acquireOrtEnv();
+        }
+        session_threads.global_pool = threads.global_pool && has_global_pool;
+        global_pool_active = session_threads.global_pool;
+        if (threads.tbb_threads > 0) {
+            tbb_limit = std::make_unique<tbb::global_control>(
+                tbb::global_control::max_allowed_parallelism, static_cast<size_t>(threads.tbb_threads));
+        }
 
         options_det = new Ort::SessionOptions();
         options_cls = new Ort::SessionOptions();
         options_rec = new Ort::SessionOptions();
 
-        options_det->SetIntraOpNumThreads(2);
-        options_det->SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_EXTENDED);
-        
-        options_cls->SetIntraOpNumThreads(2);
-        options_cls->SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_EXTENDED);
-
-        options_rec->SetIntraOpNumThreads(2);
-        options_rec->SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_EXTENDED);
+        apply_thread_params(*options_det, session_threads, threads.det_intra);
+        apply_thread_params(*options_cls, session_threads, threads.cls_intra);
+        apply_thread_params(*options_rec, session_threads, threads.rec_intra);
 
         if (is_cuda) {
             OrtCUDAProviderOptions cuda_options{}; 
@@ -201,13 +347,19 @@ std::variant<bool, std::string> PaddleOCR::initialize(const std::vector<std::str
             wstr.resize(out_len);
             w_onnx_paths.push_back(wstr);
         }
-        session_det = new Ort::Session(*env_det, w_onnx_paths[0].c_str(), *options_det);
-        session_cls = new Ort::Session(*env_cls, w_onnx_paths[1].c_str(), *options_cls);
-        session_rec = new Ort::Session(*env_rec, w_onnx_paths[2].c_str(), *options_rec);
+        std::ifstream rec_file(w_onnx_paths[2], std::ios::binary);
+        std::string rec_model = apply_rec_charset(rec_file);
+        session_det = new Ort::Session(*env, w_onnx_paths[0].c_str(), *options_det);
+        session_cls = new Ort::Session(*env, w_onnx_paths[1].c_str(), *options_cls);
+        session_rec = rec_model.empty() ? new Ort::Session(*env, w_onnx_paths[2].c_str(), *options_rec)
+                                        : new Ort::Session(*env, rec_model.data(), rec_model.size(), *options_rec);
     #else
-        session_det = new Ort::Session(*env_det, onnx_paths[0].c_str(), *options_det);
-        session_cls = new Ort::Session(*env_cls, onnx_paths[1].c_str(), *options_cls);
-        session_rec = new Ort::Session(*env_rec, onnx_paths[2].c_str(), *options_rec);
+        std::ifstream rec_file(onnx_paths[2], std::ios::binary);
+        std::string rec_model = apply_rec_charset(rec_file);
+        session_det = new Ort::Session(*env, onnx_paths[0].c_str(), *options_det);
+        session_cls = new Ort::Session(*env, onnx_paths[1].c_str(), *options_cls);
+        session_rec = rec_model.empty() ? new Ort::Session(*env, onnx_paths[2].c_str(), *options_rec)
+                                        : new Ort::Session(*env, rec_model.data(), rec_model.size(), *options_rec);
     #endif
     } catch (const Ort::Exception& e) {
         std::ostringstream oss;
@@ -226,12 +378,70 @@ std::variant<bool, std::string> PaddleOCR::initialize(const std::vector<std::str
     this->load_onnx_info(this->session_det, this->input_nodes_det, this->output_nodes_det, "det.onnx");
     this->load_onnx_info(this->session_cls, this->input_nodes_cls, this->output_nodes_cls, "cls.onnx");
     this->load_onnx_info(this->session_rec, this->input_nodes_rec, this->output_nodes_rec, "rec.onnx");
+
+    // 重新初始化时旧上下文绑定的是已释放的会话
+    idle_contexts.clear();
     
     this->is_inited = true;
+    std::cout << "preprocess kernel: " << ocr::PackKernelName() << std::endl;
     std::cout << "initialize ok!!" << std::endl;
     return true;
 }
 
+std::string PaddleOCR::apply_rec_charset(std::istream& rec_model) {
+    // 上次 initialize 已按字符集裁剪字典时重新加载完整字典，类别下标需与原始识别模型对应
+    const bool dictionary_reduced = !rec_classes.empty();
+    rec_classes.clear();
+    rec_pruned = false;
+    if (dictionary_reduced && (!this->params.dictionary || !this->dictionary.load(this->params.dictionary))) {
+        throw std::runtime_error("重新加载完整字典失败: " + std::string(this->params.dictionary ? this->params.dictionary : "NULL_PATH"));
+    }
+    if (!this->params.charset || !*this->params.charset) return std::string();
+    if (this->dictionary.size() == 0) {
+        std::cerr << "限定字符集需要先加载字典(setparms)，使用完整字典" << std::endl;
+        return std::string();
+    }
+
+    // 按UTF-8字符拆分允许集合
+    std::set<std::string_view> allowed;
+    std::string_view charset(this->params.charset);
+    for (size_t i = 0; i < charset.size();) {
+        const unsigned char lead = static_cast<unsigned char>(charset[i]);
+        size_t len = lead < 0x80 ? 1 : (lead >> 5) == 0x6 ? 2 : (lead >> 4) == 0xE ? 3 : 4;
+        len = (std::min)(len, charset.size() - i);
+        allowed.insert(charset.substr(i, len));
+        i += len;
+    }
+
+    // 类别0为CTC空白，类别 i+1 对应字典第 i 个字符
+    std::vector<int> dict_keep;
+    rec_classes.push_back(0);
+    for (size_t i = 0; i < this->dictionary.size(); ++i) {
+        if (allowed.count(this->dictionary.get_char(static_cast<int>(i)))) {
+            dict_keep.push_back(static_cast<int>(i));
+            rec_classes.push_back(static_cast<int>(i) + 1);
+        }
+    }
+    if (dict_keep.empty()) {
+        std::cerr << "字典中没有限定字符集内的字符，使用完整字典" << std::endl;
+        rec_classes.clear();
+        return std::string();
+    }
+    this->dictionary.retain(dict_keep);
+
+    std::string model((std::istreambuf_iterator<char>(rec_model)), std::istreambuf_iterator<char>());
+    std::string error;
+    std::string pruned = model.empty() ? std::string() : ocr::PruneRecHead(model, rec_classes, &error);
+    if (pruned.empty()) {
+        std::cerr << "识别模型输出头裁剪失败(" << (model.empty() ? "无法读取模型文件" : error)
+                  << ")，改为解码时屏蔽字符集外的类别" << std::endl;
+        return std::string();
+    }
+    rec_pruned = true;
+    std::cout << "识别模型输出头裁剪为 " << rec_classes.size() << " 类" << std::endl;
+    return pruned;
+}
+
 int PaddleOCR::setparms(ParamsOCR parms_in) { 
     this->params = std::move(parms_in);
     if (!this->params.dictionary || !MT::FileExists(this->params.dictionary)) {
@@ -252,7 +462,7 @@ int PaddleOCR::setparms(ParamsOCR parms_in) {
     return 1;
 }
 
-void PaddleOCR::preprocess(cv::Mat &image) {
+void PaddleOCR::preprocess(Context& ctx, cv::Mat &image) {
     int original_width = image.cols;
     int original_height = image.rows;
     
@@ -261,66 +471,53 @@ void PaddleOCR::preprocess(cv::Mat &image) {
     
     cv::Mat resized_image;
     cv::resize(image, resized_image, cv::Size(new_width, new_height));
-    
-    resized_image.convertTo(resized_image, CV_32FC3, 1.0 / 255.0);
-    cv::subtract(resized_image, cv::Scalar(0.485, 0.456, 0.406), resized_image);
-    cv::divide(resized_image, cv::Scalar(0.229, 0.224, 0.225), resized_image);
-    
-    cv::Mat blob = cv::dnn::blobFromImage(resized_image, 1.0, cv::Size(new_width, new_height), cv::Scalar(0, 0, 0), true, false);
 
     if(!input_nodes_det.empty()){ 
-         this->input_nodes_det[0].dim = {1, 3, static_cast<int64_t>(new_height), static_cast<int64_t>(new_width)};
+         ctx.det_shape = {1, 3, static_cast<int64_t>(new_height), static_cast<int64_t>(new_width)};
     } else {
         std::cerr << "Error: 前处理中input_nodes_det为空." << std::endl;
+        return;
     }
 
+    // 单遍归一化并打包进该尺寸复用的输入张量
+    ocr::PackBgrToNchw(resized_image, acquire_input(ctx.io_det, ctx.det_shape), ocr::kDetNorm);
 
-    input_images.clear();
-    input_images.push_back(std::move(blob));
 }
 
 std::variant<bool, std::string> PaddleOCR::inference(cv::Mat &image, std::vector<std::string>& texts) {
     if (image.empty()) return std::string("Image cannot be empty!");
     if (!this->is_inited) return std::string("Model not initialized!");
     
-    this->ori_img = &image; 
+    ContextLease lease(*this);
+    Context& ctx = *lease;
+    ctx.ori_img = &image; 
 
     try {
-        this->preprocess(image); 
+        this->preprocess(ctx, image); 
     } catch (const std::exception& e) {
         std::ostringstream oss;
         oss << "图像前处理失败" << e.what();
         return oss.str();
     }
 
-    std::optional<std::vector<cv::Mat>> det_result = this->infer_det(); 
+    std::optional<std::vector<cv::Mat>> det_result = this->infer_det(ctx); 
     if (!det_result.has_value() || det_result.value().empty()) { 
         return std::string("检测失败!");
     }
     std::cout << "Detection success! Found " << det_result.value().size() << " text regions." << std::endl;
 
-    std::optional<std::vector<cv::Mat>> cls_result = this->infer_cls(det_result.value());
-
-    if (!cls_result.has_value() || cls_result.value().empty()) { 
-        return std::string("方向分类失败");
-    }
-
-    std::cout << "方向分类成功！" << std::endl;
-
-    std::optional<std::vector<Ort::Value>> rec_result = this->infer_rec(cls_result.value());
-    if (!rec_result.has_value() || rec_result.value().empty()) {
-        return std::string("文本识别失败！");
-    }
-
-    std::cout << "文本识别成功，开始后处理！" << std::endl;
-
+    // 方向分类与文本识别，识别按宽度档位分批，后处理按原顺序直接写入 texts
+    bool rec_ok = false;
     try {
-        texts = this->postprocess(rec_result.value());
+        rec_ok = this->infer_cls_rec(ctx, det_result.value(), texts);
     } catch (const std::exception& e) {
         std::ostringstream oss;
         oss << "后处理失败 " << e.what();
         return oss.str();
     }
+    if (!rec_ok) {
+        return std::string("方向分类或文本识别失败！");
+    }
     
     return true;
 }
@@ -406,10 +603,11 @@ std::variant<bool, std::string> PaddleOCR::inference(cv::Mat &image, std::vector
 //     }
 // }
 
-std::vector<std::string> PaddleOCR::postprocess(std::vector<Ort::Value> &output_tensors) {
+bool PaddleOCR::postprocess(Context& ctx, std::vector<Ort::Value> &output_tensors, const std::vector<size_t>& slots,
+                            std::vector<std::string>& texts, std::vector<float>* confidences) {
     if (output_tensors.empty()) {
         std::cerr << "后处理：没有输出张量." << std::endl;
-        return std::vector<std::string>();
+        return false;
     }
   
     float* output_data = output_tensors[0].GetTensorMutableData<float>();
@@ -417,81 +615,139 @@ std::vector<std::string> PaddleOCR::postprocess(std::vector<Ort::Value> &output_
 
     if (output_shape.size() != 3) {
         std::cerr << "后处理：输出张量的维度数量不符合预期: " << output_shape.size() << std::endl;
-        return std::vector<std::string>();
+        return false;
     }
 
     long long batch_size = output_shape[0];
     long long M_sequence_len = output_shape[1]; 
     long long num_classes_dict = output_shape[2]; 
+    if (batch_size != static_cast<long long>(slots.size())) {
+        std::cerr << "后处理：识别结果数量与输入不一致: " << batch_size << " != " << slots.size() << std::endl;
+        return false;
+    }
 
     std::cout << "batch_size: " << batch_size << std::endl;
     std::cout << "M_sequence_len: " << M_sequence_len << std::endl;
     std::cout << "num_classes_dict: " << num_classes_dict << std::endl;
     
-    std::vector<std::vector<float>> max_values(batch_size, std::vector<float>(M_sequence_len, -std::numeric_limits<float>::infinity()));
-    std::vector<std::vector<size_t>> max_indices(batch_size, std::vector<size_t>(M_sequence_len, 0)); 
-
-    tbb::parallel_for(0, (int)batch_size, 1, [&](int batch_idx) {
-        tbb::parallel_for(0, (int)M_sequence_len, 1, [&](int m_idx) {
-            float current_max_val = -std::numeric_limits<float>::infinity();
-            size_t current_max_idx = 0; 
-            for (int class_idx = 0; class_idx < num_classes_dict; ++class_idx) {
-                long long flat_index = batch_idx * M_sequence_len * num_classes_dict +
-                                   m_idx * num_classes_dict +
-                                   class_idx;
-                float value = output_data[flat_index];
-
-                if (value > current_max_val) {
-                    current_max_val = value;
-                    current_max_idx = static_cast<size_t>(class_idx);
+    // 批次与时间步展平为行，每行在类别维上求argmax
+    const size_t rows = static_cast<size_t>(batch_size * M_sequence_len);
+    const int num_classes = static_cast<int>(num_classes_dict);
+    ctx.decode_max.resize(rows);
+    ctx.decode_idx.resize(rows);
+    if (!rec_classes.empty() && !rec_pruned) {
+        // 未能裁剪模型时只在允许的类别中取最大值，下标换算为 rec_classes 中的位置与字典对应
+        if (rec_classes.back() >= num_classes) {
+            std::cerr << "后处理：限定字符集的类别超出模型输出类别数 " << num_classes << std::endl;
+            return false;
+        }
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, rows, 16), [&](const tbb::blocked_range<size_t>& r) {
+            for (size_t row = r.begin(); row != r.end(); ++row) {
+                const float* probs = output_data + row * num_classes;
+                int best = 0;
+                float best_value = probs[rec_classes[0]];
+                for (size_t j = 1; j < rec_classes.size(); ++j) {
+                    if (probs[rec_classes[j]] > best_value) {
+                        best_value = probs[rec_classes[j]];
+                        best = static_cast<int>(j);
+                    }
                 }
-
+                ctx.decode_idx[row] = best;
+                ctx.decode_max[row] = best_value;
             }
-            max_values[batch_idx][m_idx] = current_max_val;
-            max_indices[batch_idx][m_idx] = current_max_idx;
         });
-    });
-
-    // print_results(max_values, max_indices);
+    } else {
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, rows, 16), [&](const tbb::blocked_range<size_t>& r) {
+            for (size_t row = r.begin(); row != r.end(); ++row) {
+                ctx.decode_idx[row] = ocr::ArgmaxF32(output_data + row * num_classes, num_classes, &ctx.decode_max[row]);
+            }
+        });
+    }
 
-    std::vector<std::string> results_text(batch_size);
     for (size_t batch_idx = 0; batch_idx < static_cast<size_t>(batch_size); ++batch_idx) {
-        std::string current_text = "";
-        size_t last_char_idx = 0; 
+        std::string& current_text = texts[slots[batch_idx]];
+        current_text.clear();
+        const int* indices = ctx.decode_idx.data() + batch_idx * M_sequence_len;
+        const float* values = ctx.decode_max.data() + batch_idx * M_sequence_len;
+        int last_char_idx = 0; 
+        float conf_sum = 0.0f;      // 输出字符的平均概率作为文本置信度
+        int conf_count = 0;
 
         for (size_t m_idx = 0; m_idx < static_cast<size_t>(M_sequence_len); ++m_idx) {
-            size_t char_idx = max_indices[batch_idx][m_idx];
-            float confidence = max_values[batch_idx][m_idx];
+            int char_idx = indices[m_idx];
+            float confidence = values[m_idx];
 
-            if (char_idx != 0 && (this->params.repeat || char_idx != last_char_idx)) {
+            if (char_idx > 0 && (this->params.repeat || char_idx != last_char_idx)) {
                  if (confidence >= this->params.text) { 
-                    std::string char_str = this->dictionary.get_char(static_cast<int>(char_idx - 1)); 
-                    current_text += char_str;
+                    // 追加时直接过滤非字母数字字符，无需再遍历一次结果
+                    for (char c : this->dictionary.get_char(char_idx - 1)) {
+                        if (std::isalnum(static_cast<unsigned char>(c))) {
+                            current_text.push_back(c);
+                        }
+                    }
+                    conf_sum += confidence;
+                    ++conf_count;
                 }
             }
-            if (char_idx != 0) { 
-                // TODO 
-            }
             last_char_idx = char_idx; 
         }
-        results_text[batch_idx] = current_text;
+        if (confidences) {
+            (*confidences)[slots[batch_idx]] = conf_count > 0 ? conf_sum / conf_count : 0.0f;
+        }
     }
 
-    for (auto& text : results_text) {
-        text.erase(
-            std::remove_if(text.begin(), text.end(), [](char c) {
-                return !std::isalnum(static_cast<unsigned char>(c));
-            }),
-            text.end()
-        );
-    }
-    return results_text;
+    return true;
 }
 
 
 
 
 
+// 凸四边形且各内角接近直角时，四条边沿外法线平移 distance 后求相邻边交点。
+// 对矩形而言即圆角外扩结果的外接矩形；不满足条件时返回 false 交由 Clipper 处理
+bool PaddleOCR::unclip_quad(const std::vector<cv::Point>& polygon, double distance, std::vector<cv::Point2f>& result) {
+    constexpr double kMaxCos = 0.1;     // 内角偏离直角约6度以内
+    if (polygon.size() != 4 || !cv::isContourConvex(polygon)) {
+        return false;
+    }
+
+    cv::Point2d pts[4];
+    for (int i = 0; i < 4; ++i) pts[i] = cv::Point2d(polygon[i].x, polygon[i].y);
+    cv::Point2d dirs[4];
+    for (int i = 0; i < 4; ++i) {
+        cv::Point2d d = pts[(i + 1) % 4] - pts[i];
+        double len = std::sqrt(d.dot(d));
+        if (len < 1e-6) return false;
+        dirs[i] = d * (1.0 / len);
+    }
+    for (int i = 0; i < 4; ++i) {
+        if (std::abs(dirs[i].dot(dirs[(i + 1) % 4])) > kMaxCos) return false;
+    }
+
+    // 按顶点绕向确定外法线方向
+    double signed_area = 0.0;
+    for (int i = 0; i < 4; ++i) signed_area += pts[i].cross(pts[(i + 1) % 4]);
+    const double side = signed_area > 0.0 ? 1.0 : -1.0;
+
+    // 第 i 条边平移后为 pts[i] + n_i * distance + t * dirs[i]，与前一条边求交得到新顶点 i
+    cv::Point2d shifted[4];
+    for (int i = 0; i < 4; ++i) {
+        cv::Point2d normal(dirs[i].y * side, -dirs[i].x * side);
+        shifted[i] = pts[i] + normal * distance;
+    }
+    result.clear();
+    result.reserve(4);
+    for (int i = 0; i < 4; ++i) {
+        const int prev = (i + 3) % 4;
+        const double denom = dirs[prev].cross(dirs[i]);
+        if (std::abs(denom) < 1e-9) return false;
+        const double t = (shifted[i] - shifted[prev]).cross(dirs[i]) / denom;
+        const cv::Point2d corner = shifted[prev] + dirs[prev] * t;
+        result.emplace_back(static_cast<float>(corner.x), static_cast<float>(corner.y));
+    }
+    return true;
+}
+
 std::vector<cv::Point2f> PaddleOCR::unclip(const std::vector<cv::Point>& polygon) { // Made input const&
     std::vector<cv::Point2f> result;
     if (polygon.empty()) return result;
@@ -505,6 +761,12 @@ std::vector<cv::Point2f> PaddleOCR::unclip(const std::vector<cv::Point>& polygon
         return result;
     }
     double distance = area * this->params.unclip_ratio / length;
+
+    // 近似矩形的凸四边形直接解析外扩，下游 minAreaRect 只取外接矩形，
+    // 与圆角外扩的结果一致，省去 Clipper 生成的大量圆弧顶点
+    if (unclip_quad(polygon, distance, result)) {
+        return result;
+    }
     
     Clipper2Lib::Path64 path;
     for (const auto& pt : polygon) {
@@ -536,37 +798,43 @@ std::vector<cv::Point2f> PaddleOCR::unclip(const std::vector<cv::Point>& polygon
     return result;
 }
 
-float PaddleOCR::box_score_slow(cv::Mat &pred, const std::vector<cv::Point> &approx) { // Made approx const&
-    if (pred.empty() || approx.empty()) {
+// 多边形内的平均概率，只在多边形外接矩形内建掩码和求均值
+float PaddleOCR::box_score(const cv::Mat &pred, const std::vector<cv::Point> &approx) {
+    if (pred.empty() || approx.size() < 3) {
         return 0.0f;
     }
     const int height = pred.rows;
     const int width = pred.cols;
-    
-    cv::Mat mask = cv::Mat::zeros(height, width, CV_8UC1);
-    
+
+    int min_x = width - 1, min_y = height - 1, max_x = 0, max_y = 0;
     std::vector<cv::Point> int_points;
     int_points.reserve(approx.size());
     for (const auto& pt : approx) {
-        int_points.emplace_back(cv::Point(
-            (std::min)((std::max)(pt.x, 0), width - 1),
-            (std::min)((std::max)(pt.y, 0), height - 1)
-        ));
-    }
-    if (int_points.size() < 3) return 0.0f;
-
+        cv::Point p((std::min)((std::max)(pt.x, 0), width - 1),
+                    (std::min)((std::max)(pt.y, 0), height - 1));
+        min_x = (std::min)(min_x, p.x);
+        min_y = (std::min)(min_y, p.y);
+        max_x = (std::max)(max_x, p.x);
+        max_y = (std::max)(max_y, p.y);
+        int_points.push_back(p);
+    }
+    const cv::Rect box(min_x, min_y, max_x - min_x + 1, max_y - min_y + 1);
+
+    // 顶点平移到外接矩形坐标系，栅格化结果与在整图上 fillPoly 相同
+    for (auto& p : int_points) {
+        p.x -= box.x;
+        p.y -= box.y;
+    }
+    cv::Mat mask = cv::Mat::zeros(box.height, box.width, CV_8UC1);
     std::vector<std::vector<cv::Point>> contours = {int_points};
     cv::fillPoly(mask, contours, cv::Scalar(1));
-    
-    // int pixel_count = cv::countNonZero(mask);
-    // if (pixel_count == 0) return 0.0f; 
 
-    cv::Scalar mean_val = cv::mean(pred, mask);
+    cv::Scalar mean_val = cv::mean(pred(box), mask);
     return static_cast<float>(mean_val[0]);
 }
 
 
-std::vector<PaddleOCR::Polygon> PaddleOCR::poly_from_bitmap(cv::Mat &pred, cv::Mat &bitmap) {
+std::vector<PaddleOCR::Polygon> PaddleOCR::poly_from_bitmap(Context& ctx, const cv::Mat &pred, const cv::Mat &bitmap) {
     std::vector<PaddleOCR::Polygon> result_polygons; // Renamed to avoid conflict
     cv::Mat binmat;
 
@@ -582,106 +850,78 @@ std::vector<PaddleOCR::Polygon> PaddleOCR::poly_from_bitmap(cv::Mat &pred, cv::M
     std::vector<std::vector<cv::Point>> contours;
     cv::findContours(binmat, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
     
-    if (input_nodes_det.empty() || ori_img == nullptr) {
-        std::cerr << "poly_from_bitmap: input_nodes_det or ori_img not initialized." << std::endl;
+    if (ctx.ori_img == nullptr) {
+        std::cerr << "poly_from_bitmap: ori_img not initialized." << std::endl;
         return result_polygons;
     }
 
-    if (input_nodes_det[0].dim.size() < 4 || input_nodes_det[0].dim[3] == 0 || input_nodes_det[0].dim[2] == 0) {
-         std::cerr << "poly_from_bitmap: Invalid dimensions in input_nodes_det." << std::endl;
+    if (ctx.det_shape.size() < 4 || ctx.det_shape[3] == 0 || ctx.det_shape[2] == 0) {
+         std::cerr << "poly_from_bitmap: Invalid det input shape." << std::endl;
          return result_polygons;
     }
 
 
-    float scale_x = static_cast<float>(this->ori_img->cols) / static_cast<float>(this->input_nodes_det[0].dim[3]);
-    float scale_y = static_cast<float>(this->ori_img->rows) / static_cast<float>(this->input_nodes_det[0].dim[2]);
+    float scale_x = static_cast<float>(ctx.ori_img->cols) / static_cast<float>(ctx.det_shape[3]);
+    float scale_y = static_cast<float>(ctx.ori_img->rows) / static_cast<float>(ctx.det_shape[2]);
 
-    for (auto &contour : contours) {
-        if (contour.size() < 3) continue; 
+    // 各轮廓相互独立，并行计算后按轮廓顺序收集，结果与串行一致
+    std::vector<std::optional<Polygon>> candidates(contours.size());
+    tbb::parallel_for(0, (int)contours.size(), 1, [&](int idx) {
+        const auto& contour = contours[idx];
+        if (contour.size() < 3) return; 
         double temp_area = cv::contourArea(contour);
-        if (temp_area < this->params.min_area) continue;
+        if (temp_area < this->params.min_area) return;
         
         double epsilon = 0.005 * cv::arcLength(contour, true); 
         std::vector<cv::Point> approx;
         cv::approxPolyDP(contour, approx, epsilon, true);
         
-        if (approx.size() < 3) continue; 
+        if (approx.size() < 3) return; 
 
-        float score = this->box_score_slow(pred, approx);
+        float score = this->box_score(pred, approx);
         if (score < this->params.thresh) {
-            continue;
+            return;
         }
         
         std::vector<cv::Point2f> unclip_poly_pts = this->unclip(approx);
         if(unclip_poly_pts.empty() || unclip_poly_pts.size() < 3) {
             std::cerr << "Unclip failed or produced too few points for a polygon." << std::endl;
-            continue; 
+            return; 
         }
 
         std::transform(unclip_poly_pts.begin(), unclip_poly_pts.end(), unclip_poly_pts.begin(),
             [&](const cv::Point2f& pt) {
                 return cv::Point2f(pt.x * scale_x, pt.y * scale_y);
             });
-        result_polygons.push_back({score, unclip_poly_pts});
+        candidates[idx] = Polygon{score, std::move(unclip_poly_pts)};
+    });
+    for (auto& candidate : candidates) {
+        if (candidate.has_value()) result_polygons.push_back(std::move(candidate.value()));
     }
     return result_polygons;
 }
 
-std::optional<std::vector<cv::Mat>> PaddleOCR::infer_det() {
-    if (input_images.empty() || input_nodes_det.empty()) {
-        std::cerr << "infer_det: No input images or det model input nodes not initialized." << std::endl;
-        return std::nullopt;
-    }
-    if (this->input_images[0].empty()){
-        std::cerr << "infer_det: Input image is empty." << std::endl;
-        return std::nullopt;
-    }
-
-
-    std::vector<Ort::Value> input_tensor_values;
-    try {
-        input_tensor_values.push_back(Ort::Value::CreateTensor<float>(
-            *memory_info, // Dereference pointer
-            this->input_images[0].ptr<float>(),
-            this->input_images[0].total(), // total number of elements
-            this->input_nodes_det[0].dim.data(),
-            this->input_nodes_det[0].dim.size())
-        );
-    } catch (const Ort::Exception& e) {
-        std::cerr << "infer_det: Failed to create input tensor: " << e.what() << std::endl;
-        return std::nullopt;
-    }
-    
-    std::vector<const char*> input_names_cstr, output_names_cstr;
-    for (const auto &node : this->input_nodes_det) input_names_cstr.push_back(node.name);
-    for (const auto &node : this->output_nodes_det) output_names_cstr.push_back(node.name);
-    if(input_names_cstr.empty() || output_names_cstr.empty()){
-        std::cerr << "infer_det: Input or output node names are empty." << std::endl;
+std::optional<std::vector<cv::Mat>> PaddleOCR::infer_det(Context& ctx) {
+    if (ctx.det_shape.empty()) {
+        std::cerr << "infer_det: Det input not prepared." << std::endl;
         return std::nullopt;
     }
 
-    std::vector<Ort::Value> output_tensor_values;
+    std::vector<Ort::Value>* output_tensor_values = nullptr;
     try {
-        output_tensor_values = this->session_det->Run(
-            Ort::RunOptions{nullptr},
-            input_names_cstr.data(), 
-            input_tensor_values.data(),
-            input_tensor_values.size(),
-            output_names_cstr.data(),
-            output_names_cstr.size()
-        );
+        output_tensor_values = run_bound(ctx.io_det, ctx.det_shape);
     } catch (const Ort::Exception& e) {
         std::cerr << "infer_det: Session Run failed: " << e.what() << std::endl;
         return std::nullopt;
     }
     
-    if (output_tensor_values.empty()) {
+    if (!output_tensor_values || output_tensor_values->empty()) {
         std::cerr << "infer_det: No output tensors from session run." << std::endl;
         return std::nullopt;
     }
 
-    float* output_data = output_tensor_values[0].GetTensorMutableData<float>();
-    const auto& output_shape = output_tensor_values[0].GetTensorTypeAndShapeInfo().GetShape();
+    float* output_data = (*output_tensor_values)[0].GetTensorMutableData<float>();
+    const auto& output_shape = (*output_tensor_values)[0].GetTensorTypeAndShapeInfo().GetShape();
     
     if (output_shape.size() != 4 || output_shape[0] != 1 || output_shape[1] != 1) {
          std::cerr << "infer_det: Unexpected output tensor shape." << std::endl;
@@ -693,15 +933,14 @@ std::optional<std::vector<cv::Mat>> PaddleOCR::infer_det() {
 
     cv::Mat prob_map = cv::Mat(static_cast<int>(output_shape[2]), static_cast<int>(output_shape[3]), CV_32FC1, output_data);
     
-    cv::Mat bitmap;
-    cv::threshold(prob_map, bitmap, this->params.thresh, 1.0, cv::THRESH_BINARY);
-    // Ensure bitmap is CV_8U for findContours later if needed by poly_from_bitmap's current logic
-    // poly_from_bitmap expects float [0,1] or uchar [0,255]. Here it's float [0,1].
+    // 单遍阈值化直接得到 findContours 所需的 uint8 二值图，缓冲随上下文复用
+    ctx.det_bitmap.create(prob_map.rows, prob_map.cols, CV_8UC1);
+    ocr::ThresholdToU8(output_data, prob_map.total(), this->params.thresh, ctx.det_bitmap.ptr<uint8_t>());
     
     // cv::rectangle(bitmap, cv::Point(0,0), cv::Point(bitmap.cols-1, bitmap.rows-1), cv::Scalar(0), 2); // This blanks the border
 
-    this->polygons = this->poly_from_bitmap(prob_map, bitmap);
-    if (polygons.empty()) {
+    ctx.polygons = this->poly_from_bitmap(ctx, prob_map, ctx.det_bitmap);
+    if (ctx.polygons.empty()) {
         std::cout << "infer_det: No polygons found from bitmap." << std::endl;
         return std::nullopt;
     }
@@ -727,7 +966,7 @@ std::optional<std::vector<cv::Mat>> PaddleOCR::infer_det() {
     }
 
 
-    for (const auto &poly : polygons) {
+    for (const auto &poly : ctx.polygons) {
         if (poly.points.size() < 4) continue; // Need at least 4 points for minAreaRect from DB output
 
         cv::RotatedRect rorect = cv::minAreaRect(poly.points);
@@ -762,7 +1001,7 @@ std::optional<std::vector<cv::Mat>> PaddleOCR::infer_det() {
         // Pad the ori_img if the rotated rect goes out of bounds to avoid warpAffine issues.
         // Or, more simply, use getRectSubPix which handles boundaries.
         try {
-             cv::getRectSubPix(*this->ori_img, rorect.size, rorect.center, cropped_img);
+             cv::getRectSubPix(*ctx.ori_img, rorect.size, rorect.center, cropped_img);
         } catch(const cv::Exception& e) {
             std::cerr << "getRectSubPix failed: " << e.what() << " for poly centered at " << rorect.center << " size " << rorect.size <<std::endl;
             // Fallback or skip this polygon
@@ -770,10 +1009,10 @@ std::optional<std::vector<cv::Mat>> PaddleOCR::infer_det() {
             cv::Rect simple_brect = cv::boundingRect(poly.points);
             simple_brect.x = (std::max)(0, simple_brect.x);
             simple_brect.y = (std::max)(0, simple_brect.y);
-            simple_brect.width = (std::min)(simple_brect.width, this->ori_img->cols - simple_brect.x);
-            simple_brect.height = (std::min)(simple_brect.height, this->ori_img->rows - simple_brect.y);
+            simple_brect.width = (std::min)(simple_brect.width, ctx.ori_img->cols - simple_brect.x);
+            simple_brect.height = (std::min)(simple_brect.height, ctx.ori_img->rows - simple_brect.y);
             if (simple_brect.width > 0 && simple_brect.height > 0) {
-                 cropped_img = (*this->ori_img)(simple_brect).clone();
+                 cropped_img = (*ctx.ori_img)(simple_brect).clone();
                  // This image is not rotated, classification step might handle it or fail.
             } else {
                 continue; // Skip if even simple bounding rect is invalid
@@ -802,253 +1041,240 @@ std::optional<std::vector<cv::Mat>> PaddleOCR::infer_det() {
     // Original code reverses polygons and images. This implies an order dependency.
     // Let's maintain it. If it's not needed, this can be removed.
     std::reverse(cropped_text_images.begin(), cropped_text_images.end());
-    std::reverse(this->polygons.begin(), this->polygons.end()); // Ensure polygons order matches images for postprocess
+    std::reverse(ctx.polygons.begin(), ctx.polygons.end()); // Ensure polygons order matches images for postprocess
 
     return cropped_text_images;
 }
 
 
-std::optional<std::vector<cv::Mat>> PaddleOCR::infer_cls(std::vector<cv::Mat>& images) {
-    if (images.empty() || input_nodes_cls.empty() || input_nodes_cls[0].dim.empty()) {
-        std::cerr << "infer_cls: No images to classify or cls model input nodes not initialized." << std::endl;
-        return std::nullopt;
-    }
-
-    int cls_input_h = static_cast<int>(this->input_nodes_cls[0].dim[2]);
-    int cls_input_w = static_cast<int>(this->input_nodes_cls[0].dim[3]);
-
-    // If model uses dynamic input size (-1), need a fixed size for batching or per-image inference.
-    // The original code used a fixed size (e.g., 192x48 or 160x80).
-    // Let's assume cls_input_h and cls_input_w are valid positive values from the loaded model.
-    if (cls_input_h <=0) cls_input_h = 48; // Default fallback
-    if (cls_input_w <=0) cls_input_w = 192; // Default fallback
-
-
-    std::vector<cv::Mat> processed_cls_images(images.size());
-    // The original code prepares two sets of images: `norm_images` for rec and `cls_images` for cls.
-    // This function should return images ready for `infer_rec`.
-    // Let's assume `norm_images` in the original code are the ones that are processed (rotated if needed) and returned.
-
-    std::vector<cv::Mat> images_for_cls_model(images.size()); // These will be fed to cls model
-
-    // The target size for recognition model (norm_images)
-    // The original `infer_cls` also prepared `norm_images` for recognition.
-    // It calculates a `max_w` based on recognition input height.
-    if (input_nodes_rec.empty() || input_nodes_rec[0].dim.size() < 4) {
-        std::cerr << "infer_cls: Recognition model input nodes not initialized for norm_images prep." << std::endl;
-        return std::nullopt;
-    }
-    int rec_input_h = static_cast<int>(this->input_nodes_rec[0].dim[2]);
-    if (rec_input_h <= 0) {
-        std::cerr << "infer_cls: Rec model height invalid for norm_images prep." << std::endl;
-        rec_input_h = 48; // Fallback
-    }
+// 按宽高比为每个文本区域选择识别宽度档位，短文本不再被同批最宽的一张拖到最大宽度
+std::vector<int> PaddleOCR::rec_widths(const std::vector<float>& aspects, int rec_input_h) {
+    std::vector<int> widths(aspects.size(), kRecWidthBuckets[0]);
+    std::cout << "Number of images to process: " << aspects.size() << std::endl;
+    for (size_t idx = 0; idx < aspects.size(); ++idx) {
+        float ratio = aspects[idx];
+        if (!(ratio > 0.0f)) continue;
+        std::cout << "Image " << idx << ": original ratio=" << ratio;
 
-    // int rec_max_w = 320; // Default max width for recognition preprocessing, can be dynamic
-    // for (const auto& img : images) {
-    //     if (img.rows == 0) continue; // Skip empty images
-    //     float ratio = static_cast<float>(img.cols) / static_cast<float>(img.rows);
-    //     // Calculate required width for rec_input_h, then round to nearest 32 multiple.
-    //     int current_rec_w = static_cast<int>(std::ceil(rec_input_h * ratio / 32.0) * 32.0);
-    //     rec_max_w = (std::max)(rec_max_w, current_rec_w);
-    // }
-    //  rec_max_w = (std::max)(rec_max_w, 32); // Ensure at least 32 width.
-
-
-    // 动态计算rec_max_w，根据输入图像的宽高比
-    int rec_max_w = 160; // 最小宽度
-    std::cout << "Number of images to process: " << images.size() << std::endl;
-    
-    for (size_t idx = 0; idx < images.size(); ++idx) {
-        const auto& img = images[idx];
-        if (img.rows == 0) continue;
-        
-        float ratio = static_cast<float>(img.cols) / static_cast<float>(img.rows);
-        std::cout << "Image " << idx << ": size=" << img.cols << "x" << img.rows 
-                  << ", original ratio=" << ratio;
-        
         // 限制宽高比在合理范围内，避免过宽的图像影响识别
         float original_ratio = ratio;
         ratio = (std::min)(ratio, 8.0f);  // 降低最大宽高比限制为6
         ratio = (std::max)(ratio, 1.5f);  // 提高最小宽高比限制为1.5
-        
         if (original_ratio != ratio) {
             std::cout << ", adjusted ratio=" << ratio;
         }
-        
+
         int current_rec_w = static_cast<int>(std::ceil(rec_input_h * ratio / 32.0) * 32.0);
-        rec_max_w = (std::max)(rec_max_w, current_rec_w);
-        
+        widths[idx] = rec_bucket_width(current_rec_w);
         std::cout << ", calculated width=" << current_rec_w << std::endl;
     }
-    
-    rec_max_w = (std::min)(rec_max_w, 512); // 降低绝对上限
-    rec_max_w = (std::max)(rec_max_w, 160);  // 确保最小宽度
-    std::cout << "Final rec_max_w: " << rec_max_w << std::endl;
-
-
-
-    // Parallel processing for image normalization
-    tbb::parallel_for(0, (int)images.size(), 1, [&](int idx) {
-        cv::Mat img_for_cls = MT::PaddingImg(images[idx], cv::Size(cls_input_w, cls_input_h));
-        // Original cls preprocessing: convert to CV_32FC1 (is it grayscale?) then normalize.
-        // If images[idx] is color, convert to gray first. Let's assume it should be color.
-        img_for_cls.convertTo(img_for_cls, CV_32FC3, 1.0 / 255.0); // Assuming BGR from OpenCV
-        cv::subtract(img_for_cls, cv::Scalar(0.5, 0.5, 0.5), img_for_cls);
-        cv::divide(img_for_cls, cv::Scalar(0.5, 0.5, 0.5), img_for_cls);
-        images_for_cls_model[idx] = img_for_cls;
-
-        // Prepare images for recognition (these will be potentially rotated and returned)
-        cv::Mat img_for_rec = MT::PaddingImg(images[idx], cv::Size(rec_max_w, rec_input_h));
-        img_for_rec.convertTo(img_for_rec, CV_32FC3, 1.0 / 255.0);
-        cv::subtract(img_for_rec, cv::Scalar(0.5, 0.5, 0.5), img_for_rec);
-        cv::divide(img_for_rec, cv::Scalar(0.5, 0.5, 0.5), img_for_rec);
-        processed_cls_images[idx] = img_for_rec; // These are the images to be returned, possibly rotated
-    });
-
-    cv::Mat blob = cv::dnn::blobFromImages(images_for_cls_model, 1.0, cv::Size(cls_input_w, cls_input_h), cv::Scalar(0,0,0), true, false);
-    
-    std::vector<Ort::Value> input_tensor_values;
-    long long cls_batch_dim[] = {static_cast<long long>(images.size()), 3, static_cast<long long>(cls_input_h), static_cast<long long>(cls_input_w)};
-    // Update input_nodes_cls[0].dim if it's used elsewhere after this, though blobFromImages uses its own size.
-    // this->input_nodes_cls[0].dim = {cls_batch_dim[0], cls_batch_dim[1], cls_batch_dim[2], cls_batch_dim[3]};
-
+    return widths;
+}
 
-    try {
-        input_tensor_values.push_back(Ort::Value::CreateTensor<float>(
-            *memory_info,
-            blob.ptr<float>(),
-            blob.total(),
-            cls_batch_dim, // Use the actual dimensions of the blob
-            4 // Number of dimensions
-        ));
-    } catch (const Ort::Exception& e) {
-        std::cerr << "infer_cls: CreateTensor failed: " << e.what() << std::endl;
-        return std::nullopt;
+int PaddleOCR::rec_input_height() const {
+    if (input_nodes_rec.empty() || input_nodes_rec[0].dim.size() < 4 || input_nodes_rec[0].dim[2] <= 0) {
+        return 48;
     }
+    return static_cast<int>(input_nodes_rec[0].dim[2]);
+}
 
-    std::vector<const char*> input_names_cstr, output_names_cstr;
-    for (const auto &node : this->input_nodes_cls) input_names_cstr.push_back(node.name);
-    for (const auto &node : this->output_nodes_cls) output_names_cstr.push_back(node.name);
-     if(input_names_cstr.empty() || output_names_cstr.empty()){
-        std::cerr << "infer_cls: Input or output node names are empty." << std::endl;
+// 方向分类，返回 items 中每个文本区域是否为180度
+std::optional<std::vector<bool>> PaddleOCR::classify_flipped(Context& ctx, const std::vector<size_t>& items, const CropPacker& pack) {
+    if (items.empty() || input_nodes_cls.empty() || input_nodes_cls[0].dim.size() < 4) {
+        std::cerr << "classify_flipped: No images to classify or cls model input nodes not initialized." << std::endl;
         return std::nullopt;
     }
 
+    int cls_input_h = static_cast<int>(this->input_nodes_cls[0].dim[2]);
+    int cls_input_w = static_cast<int>(this->input_nodes_cls[0].dim[3]);
+
+    // If model uses dynamic input size (-1), need a fixed size for batching or per-image inference.
+    // The original code used a fixed size (e.g., 192x48 or 160x80).
+    // Let's assume cls_input_h and cls_input_w are valid positive values from the loaded model.
+    if (cls_input_h <=0) cls_input_h = 48; // Default fallback
+    if (cls_input_w <=0) cls_input_w = 192; // Default fallback
+
+    // 文本区域直接缩放填充进复用的输入张量
+    const std::vector<int64_t> cls_shape = {static_cast<int64_t>(items.size()), 3, cls_input_h, cls_input_w};
+    const size_t cls_stride = static_cast<size_t>(3) * cls_input_h * cls_input_w;
+    float* cls_input = acquire_input(ctx.io_cls, cls_shape);
+    tbb::parallel_for(0, (int)items.size(), 1, [&](int k) {
+        pack(items[k], cv::Size(cls_input_w, cls_input_h), false, cls_input + k * cls_stride);
+    });
 
-    std::vector<Ort::Value> output_tensor_values;
+    std::vector<Ort::Value>* output_tensor_values = nullptr;
     try {
-        output_tensor_values = this->session_cls->Run(
-            Ort::RunOptions{nullptr},
-            input_names_cstr.data(),
-            input_tensor_values.data(),
-            input_tensor_values.size(),
-            output_names_cstr.data(),
-            output_names_cstr.size()
-        );
+        output_tensor_values = run_bound(ctx.io_cls, cls_shape);
     } catch (const Ort::Exception& e) {
-        std::cerr << "infer_cls: Session Run failed: " << e.what() << std::endl;
+        std::cerr << "classify_flipped: Session Run failed: " << e.what() << std::endl;
         return std::nullopt;
     }
 
-    if (output_tensor_values.empty()) {
-        std::cerr << "infer_cls: No output from classification model." << std::endl;
+    if (!output_tensor_values || output_tensor_values->empty()) {
+        std::cerr << "classify_flipped: No output from classification model." << std::endl;
         return std::nullopt;
     }
 
     // Output is typically [batch_size, num_classes] (e.g., [N, 2] for 0 vs 180 degrees)
-    // And a second output for confidence scores perhaps, or just logits.
-    // Original code assumes output_shape[0] is batch, output_shape[1] is 2 (scores for 0 and 180 deg).
-    float* output_data = output_tensor_values[0].GetTensorMutableData<float>();
-    const auto& output_shape = output_tensor_values[0].GetTensorTypeAndShapeInfo().GetShape();
+    float* output_data = (*output_tensor_values)[0].GetTensorMutableData<float>();
+    const auto& output_shape = (*output_tensor_values)[0].GetTensorTypeAndShapeInfo().GetShape();
 
-    if (output_shape.size() != 2 || output_shape[1] != 2) { // Check for [N, 2] shape
-        std::cerr << "infer_cls: Unexpected output shape from cls model. Expected [N, 2]." << std::endl;
+    if (output_shape.size() != 2 || output_shape[1] != 2 || output_shape[0] != static_cast<int64_t>(items.size())) {
+        std::cerr << "classify_flipped: Unexpected output shape from cls model. Expected [N, 2]." << std::endl;
         return std::nullopt;
     }
 
-    for (int i = 0; i < output_shape[0]; ++i) {
-        float score_0_deg = output_data[i * 2 + 0];
-        float score_180_deg = output_data[i * 2 + 1];
-        // If score for 180 is higher, rotate the corresponding image in `processed_cls_images`
-        if (score_180_deg > score_0_deg) { // Original: output[pos] < output[pos+1] means 180 deg
-            if (i < static_cast<int>(processed_cls_images.size())) { // Boundary check
-                 cv::rotate(processed_cls_images[i], processed_cls_images[i], cv::ROTATE_180);
-            }
-        }
+    std::vector<bool> flipped(items.size(), false);
+    for (size_t i = 0; i < items.size(); ++i) {
+        // 180度得分更高时需要旋转
+        flipped[i] = output_data[i * 2 + 1] > output_data[i * 2 + 0];
     }
-    return processed_cls_images;
+    return flipped;
 }
 
+// 方向分类 + 文本识别
+// 常开模式下所有文本区域先分类再识别；自适应模式下先按原方向识别，
+// 仅对识别置信度低于阈值的区域分类，判为180度的旋转后重新识别，取置信度更高的结果
+bool PaddleOCR::infer_cls_rec(Context& ctx, const std::vector<float>& aspects, const CropPacker& pack,
+                              std::vector<std::string>& texts) {
+    if (aspects.empty()) {
+        return false;
+    }
+    const std::vector<int> widths = rec_widths(aspects, rec_input_height());
+    std::vector<size_t> all(aspects.size());
+    for (size_t i = 0; i < all.size(); ++i) all[i] = i;
+
+    if (this->params.cls_mode == 0) {
+        std::optional<std::vector<bool>> flipped = this->classify_flipped(ctx, all, pack);
+        if (!flipped.has_value()) {
+            std::cerr << "infer_cls_rec: 方向分类失败" << std::endl;
+            return false;
+        }
+        return this->infer_rec_bucketed(ctx, all, widths, flipped.value(), pack, texts);
+    }
 
-std::optional<std::vector<Ort::Value>> PaddleOCR::infer_rec(std::vector<cv::Mat>& images) {
-    if (images.empty()) {
-        std::cerr << "infer_rec: No images to recognize." << std::endl;
-        return std::nullopt;
+    std::vector<float>& confidences = ctx.rec_conf;
+    if (!this->infer_rec_bucketed(ctx, all, widths, std::vector<bool>(all.size(), false), pack, texts, &confidences)) {
+        return false;
     }
-    if (input_nodes_rec.empty() || input_nodes_rec[0].dim.empty()) {
-        std::cerr << "infer_rec: Rec model input nodes not initialized." << std::endl;
-        return std::nullopt;
+
+    std::vector<size_t> doubtful;
+    for (size_t i = 0; i < confidences.size(); ++i) {
+        if (confidences[i] < this->params.cls_thresh) doubtful.push_back(i);
+    }
+    if (doubtful.empty()) {
+        return true;
+    }
+
+    std::optional<std::vector<bool>> flipped = this->classify_flipped(ctx, doubtful, pack);
+    if (!flipped.has_value()) {
+        // 分类失败时保留原方向的识别结果
+        return true;
     }
 
-    // All images should already be preprocessed (normalized, fixed height, padded width) by infer_cls
-    // They should all have the same dimensions here.
-    cv::Size rec_input_size = images[0].size(); // Assuming all images are same size
-    for(const auto& img : images) {
-        if (img.size() != rec_input_size) {
-            std::cerr << "infer_rec: Mismatched image sizes for batching. Expected "
-                      << rec_input_size << " got " << img.size() << std::endl;
-            // Option: resize them all to a common size, or error out.
-            // The logic in infer_cls (rec_max_w) should ensure they are same width.
-            return std::nullopt;
+    std::vector<size_t> rotated_idx;
+    for (size_t k = 0; k < doubtful.size(); ++k) {
+        if (flipped.value()[k]) rotated_idx.push_back(doubtful[k]);
+    }
+    if (rotated_idx.empty()) {
+        return true;
+    }
+    if (!this->infer_rec_bucketed(ctx, rotated_idx, widths, std::vector<bool>(aspects.size(), true), pack,
+                                  ctx.rotated_texts, &ctx.rotated_conf)) {
+        return true;
+    }
+    for (size_t k = 0; k < rotated_idx.size(); ++k) {
+        if (ctx.rotated_conf[k] > confidences[rotated_idx[k]]) {
+            // 交换而不是移动，两边的字符串容量都留在缓冲区中复用
+            texts[rotated_idx[k]].swap(ctx.rotated_texts[k]);
         }
     }
+    return true;
+}
 
-    cv::Mat blob = cv::dnn::blobFromImages(images, 1.0, rec_input_size, cv::Scalar(0,0,0), true, false);
+// 裁剪图按宽高比识别，裁剪图只作为采样源，不再生成填充后的中间图
+bool PaddleOCR::infer_cls_rec(Context& ctx, std::vector<cv::Mat>& images, std::vector<std::string>& texts) {
+    std::vector<float> aspects(images.size(), 0.0f);
+    for (size_t i = 0; i < images.size(); ++i) {
+        if (images[i].rows > 0) aspects[i] = static_cast<float>(images[i].cols) / static_cast<float>(images[i].rows);
+    }
+    return this->infer_cls_rec(ctx, aspects, [&](size_t idx, cv::Size slot, bool rotate, float* dst) {
+        const cv::Mat& img = images[idx];
+        ocr::ResizePadToNchw(img, cv::Rect2f(0.0f, 0.0f, static_cast<float>(img.cols), static_cast<float>(img.rows)),
+                             slot, rotate, dst, ocr::kClsRecNorm);
+    }, texts);
+}
 
-    std::vector<Ort::Value> input_tensor_values;
-    long long rec_batch_dim[] = {static_cast<long long>(images.size()), 3, static_cast<long long>(rec_input_size.height), static_cast<long long>(rec_input_size.width)};
-    // this->input_nodes_rec[0].dim = {rec_batch_dim[0], rec_batch_dim[1], rec_batch_dim[2], rec_batch_dim[3]};
 
-    try {
-        input_tensor_values.push_back(Ort::Value::CreateTensor<float>(
-            *memory_info,
-            blob.ptr<float>(),
-            blob.total(),
-            rec_batch_dim,
-            4 
-        ));
-    } catch (const Ort::Exception& e) {
-        std::cerr << "infer_rec: CreateTensor failed: " << e.what() << std::endl;
-        return std::nullopt;
+// 向上取最近的识别宽度档位，超过最大档位时使用最大档位
+int PaddleOCR::rec_bucket_width(int width) {
+    for (int bucket : kRecWidthBuckets) {
+        if (width <= bucket) return bucket;
     }
+    return kRecWidthBuckets[std::size(kRecWidthBuckets) - 1];
+}
 
-    std::vector<const char*> input_names_cstr, output_names_cstr;
-    for (const auto &node : this->input_nodes_rec) input_names_cstr.push_back(node.name);
-    for (const auto &node : this->output_nodes_rec) output_names_cstr.push_back(node.name);
-    if(input_names_cstr.empty() || output_names_cstr.empty()){
-        std::cerr << "infer_rec: Input or output node names are empty." << std::endl;
-        return std::nullopt;
+// 同宽度档位的文本区域合成一批推理，结果按 items 顺序写入 texts
+// widths / rotate 按文本区域下标索引
+bool PaddleOCR::infer_rec_bucketed(Context& ctx, const std::vector<size_t>& items,
+                                   const std::vector<int>& widths, const std::vector<bool>& rotate,
+                                   const CropPacker& pack, std::vector<std::string>& texts, std::vector<float>* confidences) {
+    std::map<int, std::vector<size_t>> buckets;
+    for (size_t k = 0; k < items.size(); ++k) {
+        buckets[widths[items[k]]].push_back(k);
+    }
+
+    const int rec_input_h = rec_input_height();
+    // 已有字符串保留各自容量，逐个覆盖
+    texts.resize(items.size());
+    if (confidences) confidences->assign(items.size(), 0.0f);
+    for (const auto& [width, positions] : buckets) {
+        const cv::Size slot(width, rec_input_h);
+        std::vector<Ort::Value>* rec_result = this->infer_rec(ctx, positions.size(), slot, [&](size_t b, float* dst) {
+            const size_t idx = items[positions[b]];
+            pack(idx, slot, rotate[idx], dst);
+        });
+        if (!rec_result || rec_result->empty()) {
+            return false;
+        }
+        if (!this->postprocess(ctx, *rec_result, positions, texts, confidences)) {
+            std::cerr << "infer_rec_bucketed: 识别后处理失败, 宽度 " << width << std::endl;
+            return false;
+        }
     }
+    return true;
+}
 
-    std::vector<Ort::Value> output_tensor_values;
+std::vector<Ort::Value>* PaddleOCR::infer_rec(Context& ctx, size_t count, cv::Size slot,
+                                              const std::function<void(size_t, float*)>& fill) {
+    if (count == 0) {
+        std::cerr << "infer_rec: No images to recognize." << std::endl;
+        return nullptr;
+    }
+    if (input_nodes_rec.empty() || input_nodes_rec[0].dim.empty()) {
+        std::cerr << "infer_rec: Rec model input nodes not initialized." << std::endl;
+        return nullptr;
+    }
+
+    // 同一批的文本区域宽度一致，逐个缩放填充进复用的输入张量
+    const std::vector<int64_t> rec_shape = {static_cast<int64_t>(count), 3, slot.height, slot.width};
+    const size_t rec_stride = static_cast<size_t>(3) * slot.height * slot.width;
+    float* rec_input = acquire_input(ctx.io_rec, rec_shape);
+    tbb::parallel_for(0, (int)count, 1, [&](int b) {
+        fill(static_cast<size_t>(b), rec_input + b * rec_stride);
+    });
+
+    std::vector<Ort::Value>* output_tensor_values = nullptr;
     try {
-        output_tensor_values = this->session_rec->Run(
-            Ort::RunOptions{nullptr},
-            input_names_cstr.data(),
-            input_tensor_values.data(),
-            input_tensor_values.size(),
-            output_names_cstr.data(),
-            output_names_cstr.size()
-        );
+        output_tensor_values = run_bound(ctx.io_rec, rec_shape);
     } catch (const Ort::Exception& e) {
         std::cerr << "infer_rec: Session Run failed: " << e.what() << std::endl;
-        return std::nullopt;
+        return nullptr;
     }
     
-    if (output_tensor_values.empty()) {
+    if (!output_tensor_values || output_tensor_values->empty()) {
         std::cerr << "infer_rec: No output from recognition model." << std::endl;
-        return std::nullopt;
+        return nullptr;
     }
 
     return output_tensor_values;
@@ -1058,7 +1284,8 @@ std::optional<std::vector<Ort::Value>> PaddleOCR::infer_rec(std::vector<cv::Mat>
 
 // 加入YOLO检测结果
 std::variant<bool, std::string> PaddleOCR::inference_from_custom_boxes( cv::Mat &image,
-                                                                        const std::vector<PaddleOCR::YoloDetectionBox>& custom_boxes,
+                                                                        const deploy::Box* boxes,
+                                                                        size_t count,
                                                                         std::vector<std::string>& texts) 
 {
 
@@ -1068,108 +1295,52 @@ std::variant<bool, std::string> PaddleOCR::inference_from_custom_boxes( cv::Mat
 
     if (image.empty()) return std::string("输入图像不能为空!");
     if (!this->is_inited) return std::string("模型未初始化! (请先调用 initialize，它也会加载 cls 和 rec 模型)");
-
-    this->ori_img = &image; //
-    this->polygons.clear(); //
-
-    // 1. 将 YoloDetectionBox 转换为 PaddleOCR::Polygon 并填充 this->polygons
-    for (const auto& y_box : custom_boxes) {
-        PaddleOCR::Polygon poly; //
-        poly.score = y_box.score; //
-        poly.points.emplace_back(cv::Point2f(y_box.left, y_box.top)); //
-        poly.points.emplace_back(cv::Point2f(y_box.right, y_box.top)); //
-        poly.points.emplace_back(cv::Point2f(y_box.right, y_box.bottom)); //
-        poly.points.emplace_back(cv::Point2f(y_box.left, y_box.bottom)); //
-        this->polygons.push_back(poly); //
-    }
-
-    if (this->polygons.empty()) { //
+    if (count == 0) { //
         return std::string("没有从自定义检测框中解析出多边形区域。");
     }
 
-    // 2. 根据 this->polygons 裁剪图像块
-    std::vector<cv::Mat> cropped_text_images;
-    if (input_nodes_rec.empty() || input_nodes_rec[0].dim.size() < 3 || this->input_nodes_rec[0].dim[2] <= 0) { //
-        std::cerr << "错误: inference_from_custom_boxes: 识别模型的输入节点未正确初始化或高度无效。" << std::endl; //
-        return std::string("识别模型参数错误，无法进行裁剪。");
-    }
-    int rec_input_h = static_cast<int>(this->input_nodes_rec[0].dim[2]); //
-
-    for (const auto &poly : this->polygons) {
-        if (poly.points.size() < 3) continue; // 至少需要3个点构成一个区域
-
-        cv::RotatedRect rorect = cv::minAreaRect(poly.points); //
-
-        // 标准化 rorect 的宽高和角度 (通常文本行宽度大于高度)
-        float w = rorect.size.width; //
-        float h = rorect.size.height; //
-        float angle = rorect.angle; //
-        if (w < h) { //
-            std::swap(w, h); //
-            angle += 90.0f; //
-        }
-        rorect.size = cv::Size2f(w, h); //
-        rorect.angle = angle; //
-
-        cv::Mat cropped_img_part;
-        try {
-            // 使用 getRectSubPix 从原始图像中提取旋转后的矩形区域
-            cv::getRectSubPix(*this->ori_img, rorect.size, rorect.center, cropped_img_part); //
-        } catch (const cv::Exception& e) {
-            std::cerr << "警告: getRectSubPix 提取YOLO框失败: " << e.what()
-                      << " (中心: " << rorect.center << ", 尺寸: " << rorect.size << ")" << std::endl;
-            // 降级处理：尝试使用简单的边界框裁剪
-            cv::Rect simple_brect = cv::boundingRect(poly.points); //
-            simple_brect.x = (std::max)(0, simple_brect.x); //
-            simple_brect.y = (std::max)(0, simple_brect.y); //
-            simple_brect.width = (std::min)(simple_brect.width, this->ori_img->cols - simple_brect.x); //
-            simple_brect.height = (std::min)(simple_brect.height, this->ori_img->rows - simple_brect.y); //
-            if (simple_brect.width > 0 && simple_brect.height > 0) { //
-                 cropped_img_part = (*this->ori_img)(simple_brect).clone(); //
-            } else {
-                std::cerr << "警告: 降级裁剪YOLO框也失败，跳过此框。" << std::endl;
-                continue; //
-            }
-        }
-
-        if (cropped_img_part.empty()) continue; //
-
-        // 调整到识别模型所需的固定高度，保持宽高比
-        float aspect_ratio = static_cast<float>(cropped_img_part.cols) / static_cast<float>(cropped_img_part.rows); //
-        int rec_input_w = static_cast<int>(std::round(rec_input_h * aspect_ratio)); //
-        rec_input_w = (std::max)(1, rec_input_w); // // 确保宽度至少为1
-
-        cv::Mat resized_for_rec;
-        cv::resize(cropped_img_part, resized_for_rec, cv::Size(rec_input_w, rec_input_h)); //
-        cropped_text_images.push_back(resized_for_rec); //
-    }
-
-    if (cropped_text_images.empty()) { //
+    ContextLease lease(*this);
+    Context& ctx = *lease;
+    ctx.ori_img = &image; //
+
+    // 1-2. YOLO框为轴对齐矩形，直接在原图上按区域采样并缩放填充进 cls/rec 输入张量，
+    //      不再经过 getRectSubPix + resize + PaddingImg 的中间图，也不转换成多边形。
+    //      区域取法同 minAreaRect + getRectSubPix：以框中心为中心、长边为宽，超出原图部分复制边缘。
+    //      区域与宽高比写入上下文复用的缓冲区
+    std::vector<cv::Rect2f>& rois = ctx.rois;
+    std::vector<float>& aspects = ctx.aspects;
+    rois.clear();
+    aspects.clear();
+    for (size_t i = 0; i < count; ++i) {
+        const deploy::Box& box = boxes[i];
+        float w = std::round(std::abs(box.right - box.left));
+        float h = std::round(std::abs(box.bottom - box.top));
+        if (w < h) std::swap(w, h);
+        if (w <= 0.0f || h <= 0.0f) continue;
+        const cv::Point2f center((box.left + box.right) * 0.5f, (box.top + box.bottom) * 0.5f);
+        rois.emplace_back(center.x - (w - 1.0f) * 0.5f, center.y - (h - 1.0f) * 0.5f, w, h);
+        aspects.push_back(w / h);
+    }
+
+    if (rois.empty()) { //
         return std::string("无法从自定义检测框中裁剪出任何有效的文本区域图像。");
     }
 
-    // 3. 调用 cls 模型进行方向分类
-    std::optional<std::vector<cv::Mat>> cls_result = this->infer_cls(cropped_text_images); //
-    if (!cls_result.has_value() || cls_result.value().empty()) { //
-        return std::string("方向分类(cls)阶段失败或未产生图像。");
-    }
-
-    // 4. 调用 rec 模型进行文本识别
-    std::optional<std::vector<Ort::Value>> rec_result = this->infer_rec(cls_result.value()); //
-
-    if (!rec_result.has_value() || rec_result.value().empty()) { //
-        return std::string("文本识别(rec)阶段失败或未产生结果。");
-    }
-
-    // 5. 调用 postprocess进行后处理和结果绘制
+    // 3. 方向分类与文本识别（按配置常开分类或先识别、低置信度时再分类），4. 后处理后按原顺序合并
+    //    结果直接写入调用方的 texts，复用其字符串容量
+    bool rec_ok = false;
     try {
-        //this->postprocess(rec_result.value()); // postprocess会使用 this->polygons 和 this->ori_img //
-        texts = this->postprocess(rec_result.value());
+        rec_ok = this->infer_cls_rec(ctx, aspects, [&](size_t idx, cv::Size slot, bool rotate, float* dst) {
+            ocr::ResizePadToNchw(*ctx.ori_img, rois[idx], slot, rotate, dst, ocr::kClsRecNorm);
+        }, texts);
     } catch (const std::exception& e) {
         std::ostringstream oss;
         oss << "后处理阶段失败 (使用自定义检测框)! " << e.what();
         return oss.str();
     }
+    if (!rec_ok) {
+        return std::string("方向分类(cls)或文本识别(rec)阶段失败。");
+    }
     for(int ii =0; ii<texts.size(); ii++){
         std::cout << "TEXT: " << texts[ii].c_str() << std::endl;
     }
@@ -8,6 +8,12 @@
 #include <optional>  
 #include <opencv2/opencv.hpp>
 #include <onnxruntime_cxx_api.h>
+#include <tbb/global_control.h>
+#include <memory>
+#include <list>
+#include <map>
+#include <functional>
+#include <mutex>
 #include <cstdint>   
 #include "3rdparty/clipper2/clipper.h"
 #include "3rdparty/mtools.hpp"
@@ -26,6 +32,10 @@ namespace Ort {
     struct Value;
 }
 
+namespace deploy {
+    struct Box;
+}
+
 namespace yo {
     struct Node {
         char* name = nullptr;
@@ -45,29 +55,36 @@ public:
         float thresh = 0.5f;	        // 文字区域识别阈值, 0<=thresh<=1 (Added 'f')
         float unclip_ratio = 2.0f;   // 区域扩展强度，1<=unclip_ratio
         const char* dictionary = nullptr;  	// 字典文件路径(dictionary.txt)
+        int cls_mode = 0;            // 方向分类 0->每个文本都分类 1->先识别，置信度低于cls_thresh时再分类
+        float cls_thresh = 0.9f;     // 自适应分类的识别置信度阈值
+        const char* charset = nullptr;      // 允许识别的字符(UTF-8)，为空时使用完整字典；需在 initialize 之前 setparms
+    };
+    // 推理线程配置，det/cls/rec 三个会话与检测 CPU 后端共用进程内唯一的 Ort::Env
+    struct ThreadParams {
+        bool global_pool = false;    // true: 所有会话共享 Env 的全局线程池；false: 各会话独立线程池
+        int global_intra = 0;        // 全局线程池 intra-op 线程数，0 由 ONNX Runtime 决定
+        int det_intra = 2;           // 各会话独立线程池时 det/cls/rec 的 intra-op 线程数
+        int cls_intra = 2;
+        int rec_intra = 2;
+        int inter = 1;               // inter-op 线程数，大于1时会话按并行模式执行
+        bool allow_spinning = true;  // 线程池空闲时是否自旋等待，关闭可降低空闲CPU占用
+        int tbb_threads = 0;         // 前后处理 TBB 并行线程上限，0 不限制
     };
     struct Polygon {
         float score;
         std::vector<cv::Point2f> points;
     };
-    struct YoloDetectionBox {
-        float left, top, right, bottom;
-        float score;
-    };
 private:
     bool is_inited = false;
-    cv::Mat* ori_img = nullptr;
     MT::OCRDictionary dictionary;
 
     ParamsOCR params;
-    std::vector<Polygon> polygons;
-    std::vector<cv::Mat> input_images;
     std::vector<yo::Node> input_nodes_det, input_nodes_rec, input_nodes_cls;
     std::vector<yo::Node> output_nodes_det, output_nodes_rec, output_nodes_cls;
 
-    Ort::Env* env_det = nullptr; 
-    Ort::Env* env_cls = nullptr;
-    Ort::Env* env_rec = nullptr;
+    std::shared_ptr<Ort::Env> env;                          // 进程内所有 ONNX Runtime 会话共享（含检测 CPU 后端）
+    bool global_pool_active = false;                        // 会话是否实际使用 Env 的全局线程池
+    std::unique_ptr<tbb::global_control> tbb_limit;        // TBB 并行线程上限
 
     Ort::Session* session_det = nullptr;
     Ort::Session* session_cls = nullptr;
@@ -79,21 +96,109 @@ private:
     
     Ort::MemoryInfo* memory_info = nullptr; 
 
+    // 按形状复用的张量缓冲
+    struct TensorSet {
+        std::vector<std::vector<float>> buffers;
+        std::vector<Ort::Value> values;
+    };
+    // 同一输入形状的输入与输出缓冲，outputs 在该形状首次推理后建立
+    struct PooledShape {
+        std::vector<int64_t> shape;
+        TensorSet inputs;
+        TensorSet outputs;
+    };
+    // 会话的 IoBinding 与张量池：按输入形状缓存输入输出缓冲（rec 即 (count, bucket)），
+    // 同一形状再次推理时直接绑定已有缓冲，稳态下不再分配内存；超出上限时只淘汰最久未用的形状
+    struct BoundSession {
+        Ort::Session* session = nullptr;
+        std::vector<const char*> input_names, output_names;
+        std::unique_ptr<Ort::IoBinding> binding;
+        std::list<PooledShape> lru;                  // 表头为最近使用
+        std::map<std::vector<int64_t>, std::list<PooledShape>::iterator> index;
+    };
+    static constexpr size_t kMaxPooledShapes = 64;   // 每个会话缓存的形状上限，按 LRU 淘汰
+
+    // 单次推理调用的全部可变状态。会话、字典、模型节点信息初始化后只读，由所有线程共享；
+    // 每个并发调用从池中取一个上下文独占使用，调用结束归还，张量池随上下文复用
+    struct Context {
+        cv::Mat* ori_img = nullptr;
+        std::vector<Polygon> polygons;
+        std::vector<int64_t> det_shape;             // 本次 det 输入形状
+        std::vector<cv::Rect2f> rois;               // 自定义检测框的采样区域
+        std::vector<float> aspects;                 // 对应的宽高比
+        cv::Mat det_bitmap;                         // det 概率图的二值化结果
+        BoundSession io_det, io_cls, io_rec;
+        // CTC解码复用缓冲区，逐时间步的最大概率和类别
+        std::vector<float> decode_max;
+        std::vector<int> decode_idx;
+        // 自适应分类复用缓冲区：原方向识别置信度，旋转后重新识别的文本与置信度
+        std::vector<float> rec_conf;
+        std::vector<std::string> rotated_texts;
+        std::vector<float> rotated_conf;
+    };
+    std::mutex context_mutex;
+    std::vector<std::unique_ptr<Context>> idle_contexts;
+    std::unique_ptr<Context> acquire_context();
+    void release_context(std::unique_ptr<Context> ctx);
+    // 作用域内持有一个上下文，析构时归还
+    class ContextLease {
+    public:
+        explicit ContextLease(PaddleOCR& owner) : owner_(owner), ctx_(owner.acquire_context()) {}
+        ~ContextLease() { owner_.release_context(std::move(ctx_)); }
+        ContextLease(const ContextLease&) = delete;
+        ContextLease& operator=(const ContextLease&) = delete;
+        Context& operator*() const { return *ctx_; }
+    private:
+        PaddleOCR& owner_;
+        std::unique_ptr<Context> ctx_;
+    };
+
+    static constexpr int kRecWidthBuckets[] = {160, 256, 320, 512};   // 识别输入宽度档位
+
+    // 限定字符集：rec_classes 为保留的原始类别下标(含空白类0)，字典已按其重新编号；
+    // 输出头裁剪成功时模型直接输出这些类别，否则解码时只在这些类别中取最大值；
+    // rec_classes 非空即表示字典已裁剪，重新 initialize 时先恢复完整字典
+    std::vector<int> rec_classes;
+    bool rec_pruned = false;
+    std::string apply_rec_charset(std::istream& rec_model);
+
+    void init_bound_session(BoundSession& io, Ort::Session* session,
+                            const std::vector<yo::Node>& input, const std::vector<yo::Node>& output);
+    float* acquire_input(BoundSession& io, const std::vector<int64_t>& shape);
+    std::vector<Ort::Value>* run_bound(BoundSession& io, const std::vector<int64_t>& shape);
+
     void clear_nodes_vector(std::vector<yo::Node>& nodes);
     void load_onnx_info(Ort::Session* session, std::vector<yo::Node>& input, std::vector<yo::Node>& output, const std::string& onnx_name);
 
 
 protected:
-    void preprocess(cv::Mat &image); 
+    void preprocess(Context& ctx, cv::Mat &image); 
     //void postprocess(std::vector<Ort::Value>& output_tensors); 
-    std::vector<std::string> postprocess(std::vector<Ort::Value>& output_tensors);
+    // 第 b 条识别结果写入 texts[slots[b]]，复用字符串已有容量
+    bool postprocess(Context& ctx, std::vector<Ort::Value>& output_tensors, const std::vector<size_t>& slots,
+                     std::vector<std::string>& texts, std::vector<float>* confidences = nullptr);
     std::vector<cv::Point2f> unclip(const std::vector<cv::Point>& points); 
-    float box_score_slow(cv::Mat&pred, const std::vector<cv::Point>& approx); 
-    std::vector<Polygon> poly_from_bitmap(cv::Mat &pred, cv::Mat& bitmap);
+    static bool unclip_quad(const std::vector<cv::Point>& polygon, double distance, std::vector<cv::Point2f>& result);
+    float box_score(const cv::Mat& pred, const std::vector<cv::Point>& approx); 
+    std::vector<Polygon> poly_from_bitmap(Context& ctx, const cv::Mat &pred, const cv::Mat& bitmap);
+
+    std::optional<std::vector<cv::Mat>> infer_det(Context& ctx);                                // 文本区域识别,返回文本区域的分割
 
-    std::optional<std::vector<cv::Mat>> infer_det();                                // 文本区域识别,返回文本区域的分割
-    std::optional<std::vector<cv::Mat>> infer_cls(std::vector<cv::Mat>& images);    // 文本方向识别
-    std::optional<std::vector<Ort::Value>> infer_rec(std::vector<cv::Mat>& images); // 文本内容识别
+    // 把第 idx 个文本区域缩放填充进 slot 大小的 NCHW 输入槽位，rotate 为旋转180度
+    using CropPacker = std::function<void(size_t idx, cv::Size slot, bool rotate, float* dst)>;
+    std::optional<std::vector<bool>> classify_flipped(Context& ctx, const std::vector<size_t>& items, const CropPacker& pack);
+    bool infer_cls_rec(Context& ctx, const std::vector<float>& aspects, const CropPacker& pack,
+                       std::vector<std::string>& texts);                                        // 方向分类+文本识别,按cls_mode选择策略
+    bool infer_cls_rec(Context& ctx, std::vector<cv::Mat>& images, std::vector<std::string>& texts); // 以裁剪图为采样源
+    bool infer_rec_bucketed(Context& ctx, const std::vector<size_t>& items,
+                            const std::vector<int>& widths, const std::vector<bool>& rotate,
+                            const CropPacker& pack, std::vector<std::string>& texts,
+                            std::vector<float>* confidences = nullptr); // 按宽度档位分批识别,结果按 items 顺序写入 texts
+    std::vector<int> rec_widths(const std::vector<float>& aspects, int rec_input_h);
+    int rec_input_height() const;
+    static int rec_bucket_width(int width);
+        std::vector<Ort::Value>* infer_rec(Context& ctx, size_t count, cv::Size slot,
+                                           const std::function<void(size_t, float*)>& fill);  // 文本内容识别,fill 写入同尺寸批次的每个槽位,失败返回nullptr
 public:
     PaddleOCR();
     ~PaddleOCR();
@@ -101,8 +206,14 @@ public:
     PaddleOCR(const PaddleOCR&) = delete;
     PaddleOCR& operator=(const PaddleOCR&) = delete;
 
+    // setparms 与 initialize 需在推理前完成；此后 inference / inference_from_custom_boxes
+    // 可由多个线程并发调用，共享同一套模型
     int setparms(ParamsOCR parms);
-    std::variant<bool, std::string> initialize(const std::vector<std::string>& onnx_paths, bool is_cuda);
+    std::variant<bool, std::string> initialize(const std::vector<std::string>& onnx_paths, bool is_cuda,
+                                               const ThreadParams& threads = ThreadParams());
+    // 请求全局线程池但进程内的 Env 已由其他模块以无全局线程池方式创建时，initialize 退回各会话独立线程池
+    bool uses_global_pool() const { return global_pool_active; }
     std::variant<bool, std::string> inference(cv::Mat &image, std::vector<std::string>& texts); 
-    std::variant<bool, std::string> inference_from_custom_boxes(cv::Mat &image, const std::vector<YoloDetectionBox>& custom_boxes, std::vector<std::string>& texts);
+    // boxes 直接使用检测结果的框（原图坐标），不做拷贝转换
+    std::variant<bool, std::string> inference_from_custom_boxes(cv::Mat &image, const deploy::Box* boxes, size_t count, std::vector<std::string>& texts);
 };
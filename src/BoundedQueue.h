@@ -0,0 +1,117 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+
+// 有界阻塞队列
+// 流水线各级之间传递数据，消费者阻塞等待而不是轮询休眠。
+// 队列长度达到高水位后进入拥塞状态，直到降到低水位以下才解除（滞回），
+// 拥塞期间生产者按溢出策略阻塞等待或丢弃新数据，避免内存无限增长。
+template <typename T>
+class BoundedQueue {
+public:
+    enum class OverflowPolicy {
+        Block,          // 阻塞生产者直到解除拥塞
+        DropNewest      // 丢弃新数据
+    };
+
+    BoundedQueue(size_t capacity, size_t high_watermark = 0, size_t low_watermark = 0,
+                 OverflowPolicy policy = OverflowPolicy::Block)
+        : m_capacity(capacity > 0 ? capacity : 1)
+        , m_policy(policy)
+    {
+        m_high = (high_watermark == 0 || high_watermark > m_capacity) ? m_capacity : high_watermark;
+        m_low = (low_watermark == 0 || low_watermark > m_high) ? m_high : low_watermark;
+    }
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    // 入队，被丢弃或队列已关闭时返回false
+    bool push(T item) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_closed) {
+            return false;
+        }
+        if (m_congested) {
+            if (m_policy == OverflowPolicy::DropNewest) {
+                ++m_dropped;
+                return false;
+            }
+            m_notFull.wait(lock, [this] { return !m_congested || m_closed; });
+            if (m_closed) {
+                return false;
+            }
+        }
+
+        m_items.push_back(std::move(item));
+        if (m_items.size() >= m_high) {
+            m_congested = true;
+        }
+        lock.unlock();
+        m_notEmpty.notify_one();
+        return true;
+    }
+
+    // 出队，超时或队列关闭且为空时返回false
+    template <typename Rep, typename Period>
+    bool pop(T& item, const std::chrono::duration<Rep, Period>& timeout) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (!m_notEmpty.wait_for(lock, timeout, [this] { return !m_items.empty() || m_closed; })) {
+            return false;
+        }
+        if (m_items.empty()) {
+            return false;
+        }
+
+        item = std::move(m_items.front());
+        m_items.pop_front();
+        bool released = false;
+        if (m_congested && m_items.size() <= m_low) {
+            m_congested = false;
+            released = true;
+        }
+        lock.unlock();
+        if (released) {
+            m_notFull.notify_all();
+        }
+        return true;
+    }
+
+    // 关闭队列，唤醒所有等待的生产者和消费者
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_closed = true;
+        }
+        m_notEmpty.notify_all();
+        m_notFull.notify_all();
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_items.size();
+    }
+
+    // 因拥塞被丢弃的数据数量
+    size_t dropped() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_dropped;
+    }
+
+private:
+    mutable std::mutex m_mutex;
+    std::condition_variable m_notEmpty;
+    std::condition_variable m_notFull;
+    std::deque<T> m_items;
+
+    size_t m_capacity;
+    size_t m_high;
+    size_t m_low;
+    OverflowPolicy m_policy;
+    bool m_congested = false;
+    bool m_closed = false;
+    size_t m_dropped = 0;
+};
@@ -0,0 +1,104 @@
+#include "DetectBatcher.h"
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+DetectBatcher::DetectBatcher(std::unique_ptr<deploy::DetectModel> model, int timeout_ms)
+    : m_model(std::move(model))
+    , m_timeout((std::max)(0, timeout_ms))
+    , m_batchSize((std::max)(1, m_model->batch_size()))
+{
+    m_thread = std::thread(&DetectBatcher::run, this);
+}
+
+DetectBatcher::~DetectBatcher() {
+    stop();
+}
+
+std::future<void> DetectBatcher::submit(const deploy::Image& image, deploy::DetectRes& result) {
+    std::promise<void> promise;
+    std::future<void> future = promise.get_future();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stop) {
+            promise.set_exception(std::make_exception_ptr(std::runtime_error("DetectBatcher stopped")));
+            return future;
+        }
+        m_requests.push_back(Request{image, &result, std::move(promise)});
+    }
+    m_cv.notify_one();
+    return future;
+}
+
+void DetectBatcher::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stop) {
+            return;
+        }
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+
+    // 线程退出后剩余的请求不再处理
+    for (auto& request : m_requests) {
+        request.promise.set_exception(std::make_exception_ptr(std::runtime_error("DetectBatcher stopped")));
+    }
+    m_requests.clear();
+}
+
+void DetectBatcher::run() {
+    std::vector<Request> batch;
+    std::vector<deploy::Image> images;
+    std::vector<deploy::DetectRes> results;
+    batch.reserve(m_batchSize);
+    images.reserve(m_batchSize);
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [this] { return m_stop || !m_requests.empty(); });
+            if (m_stop) {
+                return;
+            }
+
+            // 从第一张到达开始计时，凑满一批或超时即提交
+            auto deadline = std::chrono::steady_clock::now() + m_timeout;
+            m_cv.wait_until(lock, deadline, [this] {
+                return m_stop || static_cast<int>(m_requests.size()) >= m_batchSize;
+            });
+            if (m_stop) {
+                return;
+            }
+
+            size_t count = (std::min)(m_requests.size(), static_cast<size_t>(m_batchSize));
+            for (size_t i = 0; i < count; ++i) {
+                batch.push_back(std::move(m_requests.front()));
+                m_requests.pop_front();
+            }
+        }
+
+        for (const auto& request : batch) {
+            images.push_back(request.image);
+        }
+
+        try {
+            m_model->predict(images, results);
+            // 交换而非移动，请求方旧结果的容量留在 results 中供下一批复用
+            for (size_t i = 0; i < batch.size(); ++i) {
+                std::swap(*batch[i].result, results[i]);
+                batch[i].promise.set_value();
+            }
+        } catch (...) {
+            for (auto& request : batch) {
+                request.promise.set_exception(std::current_exception());
+            }
+        }
+
+        batch.clear();
+        images.clear();
+    }
+}
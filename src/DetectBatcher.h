@@ -0,0 +1,49 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "yolo/model.hpp"
+
+// 检测批处理
+// 多个线程提交的拼接图在此汇聚，凑满 batch_size() 张或等待超过截止时间后
+// 调用一次 predict(vector<Image>)，结果按提交顺序交换进各请求的 result。
+// 提交方需保证图像数据和 result 在 future 就绪前有效，且期间不访问 result。
+class DetectBatcher {
+public:
+    DetectBatcher(std::unique_ptr<deploy::DetectModel> model, int timeout_ms);
+    ~DetectBatcher();
+
+    DetectBatcher(const DetectBatcher&) = delete;
+    DetectBatcher& operator=(const DetectBatcher&) = delete;
+
+    // 提交一张图像，检测完成后结果与内部缓冲交换到 result，容量在批次间循环复用
+    std::future<void> submit(const deploy::Image& image, deploy::DetectRes& result);
+
+    int batchSize() const { return m_batchSize; }
+
+    // 停止批处理线程，未处理的请求以异常结束
+    void stop();
+
+private:
+    struct Request {
+        deploy::Image image;
+        deploy::DetectRes* result;
+        std::promise<void> promise;
+    };
+
+    void run();
+
+    std::unique_ptr<deploy::DetectModel> m_model;
+    std::chrono::milliseconds m_timeout;
+    int m_batchSize;
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<Request> m_requests;
+    bool m_stop = false;
+    std::thread m_thread;
+};
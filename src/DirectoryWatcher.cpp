@@ -0,0 +1,86 @@
+#include "DirectoryWatcher.h"
+#include <thread>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+DirectoryWatcher::DirectoryWatcher(const std::string& dirPath) {
+#ifdef _WIN32
+    HANDLE handle = FindFirstChangeNotificationA(dirPath.c_str(), FALSE,
+        FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE);
+    m_handle = (handle == INVALID_HANDLE_VALUE) ? nullptr : handle;
+#elif defined(__linux__)
+    m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_fd >= 0) {
+        m_wd = inotify_add_watch(m_fd, dirPath.c_str(), IN_CREATE | IN_MOVED_TO | IN_CLOSE_WRITE);
+        if (m_wd < 0) {
+            close(m_fd);
+            m_fd = -1;
+        }
+    }
+#else
+    (void)dirPath;
+#endif
+}
+
+DirectoryWatcher::~DirectoryWatcher() {
+#ifdef _WIN32
+    if (m_handle) {
+        FindCloseChangeNotification(static_cast<HANDLE>(m_handle));
+    }
+#elif defined(__linux__)
+    if (m_fd >= 0) {
+        if (m_wd >= 0) {
+            inotify_rm_watch(m_fd, m_wd);
+        }
+        close(m_fd);
+    }
+#endif
+}
+
+bool DirectoryWatcher::isNotifying() const {
+#ifdef _WIN32
+    return m_handle != nullptr;
+#elif defined(__linux__)
+    return m_fd >= 0;
+#else
+    return false;
+#endif
+}
+
+bool DirectoryWatcher::waitForChange(std::chrono::milliseconds timeout) {
+#ifdef _WIN32
+    if (m_handle) {
+        DWORD ret = WaitForSingleObject(static_cast<HANDLE>(m_handle), static_cast<DWORD>(timeout.count()));
+        if (ret != WAIT_OBJECT_0) {
+            return false;
+        }
+        // 重新挂起通知，等待下一次变化
+        FindNextChangeNotification(static_cast<HANDLE>(m_handle));
+        return true;
+    }
+#elif defined(__linux__)
+    if (m_fd >= 0) {
+        pollfd pfd{m_fd, POLLIN, 0};
+        if (poll(&pfd, 1, static_cast<int>(timeout.count())) <= 0) {
+            return false;
+        }
+        // 读空事件队列，调用方自行重新扫描目录
+        alignas(inotify_event) char buffer[4096];
+        while (read(m_fd, buffer, sizeof(buffer)) > 0) {
+        }
+        return true;
+    }
+#endif
+    // 无法监听时按超时轮询，视为可能有变化
+    std::this_thread::sleep_for(timeout);
+    return true;
+}
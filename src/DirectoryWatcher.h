@@ -0,0 +1,30 @@
+#pragma once
+#include <chrono>
+#include <string>
+
+// 目录变化监听
+// 用于流式接入：过车过程中相机持续写入图片，等待目录内新建文件/子目录后再扫描，
+// 避免忙等轮询。Windows 使用目录变更通知，Linux 使用 inotify，
+// 无法建立监听时退化为按超时定时轮询，调用方逻辑不变。
+class DirectoryWatcher {
+public:
+    explicit DirectoryWatcher(const std::string& dirPath);
+    ~DirectoryWatcher();
+
+    DirectoryWatcher(const DirectoryWatcher&) = delete;
+    DirectoryWatcher& operator=(const DirectoryWatcher&) = delete;
+
+    // 等待目录内容变化，有变化返回true，超时返回false
+    bool waitForChange(std::chrono::milliseconds timeout);
+
+    // 是否使用系统通知（否则为定时轮询）
+    bool isNotifying() const;
+
+private:
+#ifdef _WIN32
+    void* m_handle = nullptr;   // FindFirstChangeNotification 句柄
+#elif defined(__linux__)
+    int m_fd = -1;              // inotify 实例
+    int m_wd = -1;              // 目录监听描述符
+#endif
+};
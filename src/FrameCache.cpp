@@ -0,0 +1,38 @@
+#include "FrameCache.h"
+#include <algorithm>
+
+FrameCache::FrameCache(size_t capacity, Loader loader)
+    : m_slots((std::max)(capacity, static_cast<size_t>(1)))
+    , m_loader(std::move(loader))
+{
+}
+
+FrameCache::~FrameCache() {
+    clear();
+}
+
+void FrameCache::prefetch(size_t index) {
+    Slot& slot = m_slots[index % m_slots.size()];
+    if (slot.valid && slot.index == index) {
+        return;
+    }
+
+    // 覆盖旧槽位，旧帧已离开窗口
+    slot.index = index;
+    slot.valid = true;
+    slot.frame = std::async(std::launch::async, m_loader, index).share();
+}
+
+cv::Mat FrameCache::get(size_t index) {
+    prefetch(index);
+    return m_slots[index % m_slots.size()].frame.get();
+}
+
+void FrameCache::clear() {
+    for (auto& slot : m_slots) {
+        if (slot.valid && slot.frame.valid()) {
+            slot.frame.wait();
+        }
+        slot = Slot();
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <vector>
+#include <opencv2/core/mat.hpp>
+
+// 滑动窗口帧缓存
+// 按图片序号缓存解码结果，每张图片只解码一次；槽位按 序号 % 容量 复用，
+// 新序号写入时覆盖的旧帧即已滑出拼接窗口。
+class FrameCache {
+public:
+    using Loader = std::function<cv::Mat(size_t index)>;
+
+    FrameCache(size_t capacity, Loader loader);
+    ~FrameCache();
+
+    FrameCache(const FrameCache&) = delete;
+    FrameCache& operator=(const FrameCache&) = delete;
+
+    // 异步预取序号为 index 的帧，已在缓存中则直接返回
+    void prefetch(size_t index);
+
+    // 获取序号为 index 的帧，未命中时先解码
+    cv::Mat get(size_t index);
+
+    // 清空缓存，等待尚未完成的解码任务
+    void clear();
+
+private:
+    struct Slot {
+        size_t index = 0;
+        bool valid = false;
+        std::shared_future<cv::Mat> frame;
+    };
+
+    std::vector<Slot> m_slots;
+    Loader m_loader;
+};
@@ -0,0 +1,98 @@
+#include "ImageStitcher.h"
+#include <algorithm>
+#include <cmath>
+#include <opencv2/imgproc.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include "filetools.h"
+
+ImageStitcher::ImageStitcher(const cv::Size& final_target_size, double band_top, double band_bottom)
+    : m_targetSize(final_target_size)
+{
+    // 非法区域时退回整幅图像
+    band_top = (std::clamp)(band_top, 0.0, 1.0);
+    band_bottom = (std::clamp)(band_bottom, 0.0, 1.0);
+    if (band_top >= band_bottom) {
+        band_top = 0.0;
+        band_bottom = 1.0;
+    }
+
+    m_bandTop = static_cast<int>(std::lround(band_top * final_target_size.height));
+    m_bandBottom = static_cast<int>(std::lround(band_bottom * final_target_size.height));
+    m_bandBottom = (std::max)(m_bandBottom, m_bandTop + 1);
+    m_tileSize = cv::Size(final_target_size.width / 3, m_bandBottom - m_bandTop);
+}
+
+void ImageStitcher::setDecodeScale(int decode_scale)
+{
+    if (decode_scale != 0 && decode_scale != 1 && decode_scale != 2 && decode_scale != 4 && decode_scale != 8) {
+        decode_scale = 1;
+    }
+    m_decodeScale = decode_scale;
+}
+
+int ImageStitcher::autoDecodeScale(const cv::Size& src_size) const
+{
+    // 缩小解码后宽度不小于拼接块宽度、高度不小于保留区域高度（拼接块高度）
+    for (int scale : { 8, 4, 2 }) {
+        if (src_size.width / scale >= m_tileSize.width && src_size.height / scale >= m_tileSize.height) {
+            return scale;
+        }
+    }
+    return 1;
+}
+
+cv::Mat ImageStitcher::loadTile(const std::string& path) const
+{
+    int scale = m_decodeScale;
+    if (scale == 0) {
+        cv::Size src_size;
+        scale = FileTools::getInstance().GetJpegSize(path, src_size) ? autoDecodeScale(src_size) : 1;
+    }
+
+    int flags = cv::IMREAD_COLOR;
+    switch (scale) {
+    case 2: flags = cv::IMREAD_REDUCED_COLOR_2; break;
+    case 4: flags = cv::IMREAD_REDUCED_COLOR_4; break;
+    case 8: flags = cv::IMREAD_REDUCED_COLOR_8; break;
+    default: break;
+    }
+
+    return makeTile(cv::imread(path, flags));
+}
+
+cv::Mat ImageStitcher::makeTile(const cv::Mat& img) const
+{
+    if (img.empty()) {
+        return cv::Mat();
+    }
+
+    // 拼接图第 y 行对应原图 [y * rows / H, (y + 1) * rows / H) 行，按此映射截取原图的保留区域
+    const int full_height = m_targetSize.height;
+    int src_top = static_cast<int>(static_cast<int64_t>(m_bandTop) * img.rows / full_height);
+    int src_bottom = static_cast<int>((static_cast<int64_t>(m_bandBottom) * img.rows + full_height - 1) / full_height);
+    src_bottom = (std::min)((std::max)(src_bottom, src_top + 1), img.rows);
+
+    cv::Mat tile;
+    cv::resize(img(cv::Rect(0, src_top, img.cols, src_bottom - src_top)), tile, m_tileSize, 0, 0, cv::INTER_AREA);
+    return tile;
+}
+
+cv::Mat ImageStitcher::stitch(const cv::Mat& tile1, const cv::Mat& tile2, const cv::Mat& tile3) const
+{
+    if (tile1.empty() || tile2.empty() || tile3.empty()) {
+        return cv::Mat();
+    }
+
+    // 预分配最终图像，拼接块直接拷贝到目标区域
+    cv::Mat final_image(m_tileSize.height, m_tileSize.width * 3, tile1.type());
+
+    cv::Rect roi1(0, 0, m_tileSize.width, m_tileSize.height);
+    cv::Rect roi2(m_tileSize.width, 0, m_tileSize.width, m_tileSize.height);
+    cv::Rect roi3(2 * m_tileSize.width, 0, m_tileSize.width, m_tileSize.height);
+
+    tile1.copyTo(final_image(roi1));
+    tile2.copyTo(final_image(roi2));
+    tile3.copyTo(final_image(roi3));
+
+    return final_image;
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <string>
+#include <opencv2/core/mat.hpp>
+
+// 侧部图片拼接
+// 每张图片缩放为一个 (宽/3 x 高) 的拼接块，相邻3个拼接块横向拼成一张拼接图。
+// 同一张图片会出现在连续3个拼接窗口中，拼接块只需生成一次，配合 FrameCache 缓存复用。
+//
+// 拼接图只保留 [band_top, band_bottom) 的纵向区域（按拼接图高度的比例），
+// 该区域映射回原图行后只缩放这部分像素，输出的拼接图只包含检测需要的像素。
+class ImageStitcher {
+public:
+    ImageStitcher(const cv::Size& final_target_size, double band_top = 0.0, double band_bottom = 1.0);
+
+    // 设置JPEG解码缩放倍数：0 自动选择，1 原尺寸，2/4/8 强制按该倍数缩小解码
+    void setDecodeScale(int decode_scale);
+
+    // 按解码缩放倍数读取图片并生成拼接块
+    cv::Mat loadTile(const std::string& path) const;
+
+    // 将原图中保留区域对应的行缩放为拼接块
+    cv::Mat makeTile(const cv::Mat& img) const;
+
+    // 将3个拼接块拷贝到拼接图中
+    cv::Mat stitch(const cv::Mat& tile1, const cv::Mat& tile2, const cv::Mat& tile3) const;
+
+    cv::Size tileSize() const { return m_tileSize; }
+    cv::Size targetSize() const { return m_targetSize; }
+
+private:
+    // 在保证缩小解码后宽度不小于拼接块宽度、高度不小于保留区域高度的前提下，选择最大的缩放倍数
+    int autoDecodeScale(const cv::Size& src_size) const;
+
+    cv::Size m_targetSize;
+    cv::Size m_tileSize;
+    int m_bandTop;          // 保留区域在拼接图中的起始行
+    int m_bandBottom;       // 保留区域在拼接图中的结束行（不含）
+    int m_decodeScale = 1;  // JPEG解码缩放倍数，0 为自动
+};
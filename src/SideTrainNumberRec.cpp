@@ -95,37 +95,6 @@ void SideTrainNumberRec::logMessage(const QString& message)
     ui->textEditLog->ensureCursorVisible();
 }
 
-void SideTrainNumberRec::preloadImages(const QStringList& imageFiles, int startIdx, int count)
-{
-    // 确保索引范围有效
-    if (startIdx < 0 || startIdx >= imageFiles.size() || count <= 0) {
-        return;
-    }
-    
-    // 计算实际要加载的图片数量（不超出范围）
-    int endIdx = (std::min)(startIdx + count, static_cast<int>(imageFiles.size()));
-    
-    // 创建异步任务列表
-    std::vector<std::future<void>> futures;
-    
-    // 启动异步加载任务
-    for (int i = startIdx; i < endIdx; ++i) {
-        futures.push_back(std::async(std::launch::async, [this, i, &imageFiles]() {
-            QString fullPath = currentImageDir + "/" + imageFiles[i];
-            cv::Mat img = cv::imread(fullPath.toStdString());
-            if (!img.empty()) {
-                std::lock_guard<std::mutex> lock(m_cacheMutex);
-                m_imageCache[imageFiles[i]] = img;
-            }
-        }));
-    }
-    
-    // 等待所有加载完成
-    for (auto& future : futures) {
-        future.wait();
-    }
-}
-
 bool SideTrainNumberRec::processImages(const QString& dirPath)
 {
     QDir dir(dirPath);
@@ -153,16 +122,19 @@ bool SideTrainNumberRec::processImages(const QString& dirPath)
         ui->progressBar->setValue(0);
     });
     
-    // 清空图片缓存
-    {
-        std::lock_guard<std::mutex> lock(m_cacheMutex);
-        m_imageCache.clear();
+    // 只保留拼接图的下半部分
+    ImageStitcher stitcher(cv::Size(1200, 1200), 0.5, 1.0);
+    stitcher.setDecodeScale(0);
+
+    // 滑动窗口缓存：拼接窗口3张 + 预取1张，每张图片只解码并缩放一次
+    FrameCache frameCache(4, [this, &imageFiles, &stitcher](size_t idx) {
+        QString fullPath = currentImageDir + "/" + imageFiles[static_cast<int>(idx)];
+        return stitcher.loadTile(fullPath.toStdString());
+    });
+    for (int j = 0; j < (std::min)(3, static_cast<int>(imageFiles.size())); ++j) {
+        frameCache.prefetch(j);
     }
     
-    // 预加载前6张图片（或全部，如果少于6张）
-    int preloadCount = (std::min)(6, imageFiles.size());
-    preloadImages(imageFiles, 0, preloadCount);
-    
     manualTask task;
     task.timestamp = QDateTime::currentDateTime().toString("yyyyMMddhhmmss").toStdString();
     
@@ -171,12 +143,9 @@ bool SideTrainNumberRec::processImages(const QString& dirPath)
             return false;
         }
         
-        // 当处理到第i组时，预加载i+6组的图片（如果存在）
-        if (i + 6 < imageFiles.size()) {
-            // 异步预加载，不等待完成
-            std::thread([this, i, &imageFiles]() {
-                preloadImages(imageFiles, i + 6, 3);
-            }).detach();
+        // 预取下一个窗口新增的图片
+        if (i + 3 < imageFiles.size()) {
+            frameCache.prefetch(i + 3);
         }
         
         if (i == 0) {
@@ -193,83 +162,35 @@ bool SideTrainNumberRec::processImages(const QString& dirPath)
             ui->progressBar->setValue(i);
         });
 
-        // 从缓存加载图片，如果缓存中没有则直接加载
-        cv::Mat image1, image2, image3;
-        {
-            std::lock_guard<std::mutex> lock(m_cacheMutex);
-            
-            // 尝试从缓存获取图片1
-            auto it1 = m_imageCache.find(imageFiles[i]);
-            if (it1 != m_imageCache.end()) {
-                image1 = it1->second.clone(); // 使用clone避免多线程访问同一数据
-                m_imageCache.erase(it1); // 使用后从缓存移除以节省内存
-            } else {
-                QString fullPath = currentImageDir + "/" + imageFiles[i];
-                image1 = cv::imread(fullPath.toStdString());
-            }
-            
-            // 尝试从缓存获取图片2
-            auto it2 = m_imageCache.find(imageFiles[i + 1]);
-            if (it2 != m_imageCache.end()) {
-                image2 = it2->second.clone();
-                m_imageCache.erase(it2);
-            } else {
-                QString fullPath = currentImageDir + "/" + imageFiles[i + 1];
-                image2 = cv::imread(fullPath.toStdString());
-            }
-            
-            // 尝试从缓存获取图片3
-            auto it3 = m_imageCache.find(imageFiles[i + 2]);
-            if (it3 != m_imageCache.end()) {
-                image3 = it3->second.clone();
-                m_imageCache.erase(it3);
-            } else {
-                QString fullPath = currentImageDir + "/" + imageFiles[i + 2];
-                image3 = cv::imread(fullPath.toStdString());
-            }
-        }
+        // 从滑动窗口缓存获取图片
+        cv::Mat image1 = frameCache.get(i);
+        cv::Mat image2 = frameCache.get(i + 1);
+        cv::Mat image3 = frameCache.get(i + 2);
 
         if (image1.empty() || image2.empty() || image3.empty()) {
             logMessage(QString("无法加载图片组，跳过处理"));
             continue;
         }
         
-        cv::Size final_target_size = cv::Size(1200, 1200);
-        int target_height = static_cast<int>(image1.rows / 2.0);
-        int target_width_per_img = final_target_size.width / 3;
-   
-        cv::Mat final_image(final_target_size, image1.type());
-   
-        cv::Rect roi1(0, 0, target_width_per_img, final_target_size.height);
-        cv::Rect roi2(target_width_per_img, 0, target_width_per_img, final_target_size.height);
-        cv::Rect roi3(2 * target_width_per_img, 0, target_width_per_img, final_target_size.height);
-   
-        cv::resize(image1, final_image(roi1), roi1.size(), 0, 0, cv::INTER_AREA);
-        cv::resize(image2, final_image(roi2), roi2.size(), 0, 0, cv::INTER_AREA);
-        cv::resize(image3, final_image(roi3), roi3.size(), 0, 0, cv::INTER_AREA);
-
-        // 把图像高度去除一般保留下半部分图片
-        int half_height = final_image.rows / 2;
-        cv::Rect roi(0, half_height, final_image.cols, half_height);
-        cv::Mat cropped_image = final_image(roi);
+        // 拼接图只包含下半部分
+        cv::Mat cropped_image = stitcher.stitch(image1, image2, image3);
 
         // 设置任务数据
         task.image = cropped_image;
         task.imageSequenceNumber = imageFiles[i].toStdString();
 
-        {
-            std::lock_guard<std::mutex> lock(*m_threadManager->m_mtx_picProcess);
-            ThreadManager::StitchedImageData data;
-            data.image = task.image;
-            data.imageSequenceNumber = task.imageSequenceNumber;
-            data.timestamp = task.timestamp;
-            data.flag = task.flag;
-            
-            m_threadManager->m_queue_picProcess.push(data);
-            logMessage(QString("已提交图片组 %1 到处理队列").arg(task.imageSequenceNumber.c_str()));
-        }
+        ThreadManager::StitchedImageData data;
+        data.image = task.image;
+        data.imageSequenceNumber = task.imageSequenceNumber;
+        data.timestamp = task.timestamp;
+        data.flag = task.flag;
 
-        QThread::msleep(10);
+        // 处理队列满时阻塞，按检测速度提交
+        if (!m_threadManager->m_queue_picProcess->push(data)) {
+            logMessage(QString("处理队列已关闭，停止提交"));
+            return false;
+        }
+        logMessage(QString("已提交图片组 %1 到处理队列").arg(task.imageSequenceNumber.c_str()));
     }
     
     // 更新最终进度
@@ -35,8 +35,6 @@ private slots:
     void onProcessClicked();
 
 private:
-    // 异步预加载图片
-    void preloadImages(const QStringList& imageFiles, int startIdx, int count);
     bool processImages(const QString& dirPath);
     void sortImageFiles(QStringList& imageFiles);
 
@@ -49,8 +47,6 @@ private:
 
 private:
     std::unique_ptr<ThreadManager> m_threadManager;
-    std::unordered_map<QString, cv::Mat> m_imageCache; // 图片缓存
-    std::mutex m_cacheMutex; // 缓存互斥锁
 
 private:
     Ui_SideTrainNumberRec* ui;
@@ -2,23 +2,21 @@
 ThreadManager::ThreadManager(QObject *parent)
     : QObject(parent)
     , threadStop(false)
-    , m_mtx_udpTool(std::make_shared<std::mutex>())
-    , m_mtx_udpProcess(std::make_shared<std::mutex>())
-    , m_mtx_picProcess(std::make_shared<std::mutex>())
-    , m_trainParser(std::make_unique<TrainParser>())
-    , m_MetrotrainParser(std::make_unique<MetroTrainParser>())
-    , m_trainNumberDetector(std::make_unique<TrainNumberDetector>())
 {
 
     // 读取参数
     std::string exePath = FileTools::getInstance().GetExePath();
     m_ConfigRead = std::make_unique<ConfigRead>();
-    m_ConfigRead->ReadConfig(exePath + "\\Config.ini", m_GlobalParam, m_udpToolParam, m_AlgParam);
+    m_ConfigRead->ReadConfig(exePath + "\\Config.ini", m_GlobalParam, m_udpToolParam, m_AlgParam, m_OCRParam);
 
-    // 配置算法参数
-    m_trainNumberDetector->MAX_EMPTY_FRAMES = m_AlgParam.max_empty_frames;
-    m_trainNumberDetector->MIN_LENGTH = m_AlgParam.min_length;
-    m_trainNumberDetector->TRAIN_TYPE = m_AlgParam.trian_type;
+    // 创建流水线队列
+    m_queue_udpTool = std::make_unique<BoundedQueue<TaskRequest>>(
+        (std::max)(1, m_GlobalParam.udpQueueCapacity), 0, 0, BoundedQueue<TaskRequest>::OverflowPolicy::DropNewest);
+    // 仅界面手动处理使用；UDP/流式任务在任务线程内拼接后直接检测，不经过此队列
+    m_queue_picProcess = std::make_unique<BoundedQueue<StitchedImageData>>(
+        (std::max)(1, m_GlobalParam.picQueueCapacity),
+        (std::max)(0, m_GlobalParam.picQueueHighWatermark),
+        (std::max)(0, m_GlobalParam.picQueueLowWatermark));
 
     // 创建UDP工具
     m_udpTool = std::make_unique<UdpTool>();
@@ -27,6 +25,16 @@ ThreadManager::ThreadManager(QObject *parent)
     // 创建目标检测器
     deploy::InferOption option;
     option.enableSwapRB();
+    option.setDecodeParams(m_GlobalParam.detScoreThresh, m_GlobalParam.detIouThresh, m_GlobalParam.detMaxDetections);
+    if (m_GlobalParam.performanceReport) {
+        option.enablePerformanceReport();
+    }
+    if (m_GlobalParam.inferBackend == 1) {
+        // CPU 后端，模型路径需配置为 .onnx 文件
+        option.setBackend(deploy::InferBackend::OnnxRuntimeCPU);
+        option.setCpuThreads(m_GlobalParam.cpuThreads);
+        m_logger->logInfo(fmt::format("使用ONNX Runtime CPU推理后端, 线程数 {}", m_GlobalParam.cpuThreads), false);
+    }
 
     // 创建模型实例
     if (m_GlobalParam.recMode == 0) {
@@ -37,26 +45,47 @@ ThreadManager::ThreadManager(QObject *parent)
     else if (m_GlobalParam.recMode == 1) {
         m_logger->logInfo(fmt::format("使用OCR模式识别"), false);
         emit m_Logs(QString("使用OCR模式识别"));
-        m_detector = std::make_unique<deploy::DetectModel>(m_GlobalParam.modelPath, option);
         m_paddleOcr = std::make_unique<PaddleOCR>();
         std::vector<std::string> onnx_paths{m_GlobalParam.OCRDetPath, m_GlobalParam.OCRClsPath, m_GlobalParam.OCRRecPath};
-        std::variant<bool, std::string> init_status = m_paddleOcr->initialize(onnx_paths, true);
-        if (init_status.index() == 1) { 
-            std::string error_message = std::get<std::string>(init_status);
-            m_logger->logError(fmt::format("OCR模型初始化失败: {}", error_message), false);
-            return; 
-        }
-        m_logger->logInfo(fmt::format("OCR 引擎初始化成功!"), false);
+        PaddleOCR::ThreadParams ocr_threads;
+        ocr_threads.global_pool = m_OCRParam.globalThreadPool;
+        ocr_threads.global_intra = m_OCRParam.globalIntraThreads;
+        ocr_threads.det_intra = m_OCRParam.detIntraThreads;
+        ocr_threads.cls_intra = m_OCRParam.clsIntraThreads;
+        ocr_threads.rec_intra = m_OCRParam.recIntraThreads;
+        ocr_threads.inter = m_OCRParam.interThreads;
+        ocr_threads.allow_spinning = m_OCRParam.allowSpinning;
+        ocr_threads.tbb_threads = m_OCRParam.tbbThreads;
+        m_logger->logInfo(fmt::format("OCR推理线程: {}, intra {}/{}/{}, inter {}, 自旋 {}, TBB上限 {}",
+            ocr_threads.global_pool ? fmt::format("全局线程池({})", ocr_threads.global_intra) : std::string("独立线程池"),
+            ocr_threads.det_intra, ocr_threads.cls_intra, ocr_threads.rec_intra,
+            ocr_threads.inter, ocr_threads.allow_spinning, ocr_threads.tbb_threads), false);
+        // 先加载字典，限定字符集时 initialize 需要按字典裁剪识别模型
         m_ParamsOCR.repeat = false;
         m_ParamsOCR.min_area = 100;
         m_ParamsOCR.text = 0.25f;
         m_ParamsOCR.thresh = 0.25f;
         m_ParamsOCR.unclip_ratio = 2.5f;
         m_ParamsOCR.dictionary = m_GlobalParam.dictPath.c_str(); ;
+        m_ParamsOCR.cls_mode = m_OCRParam.clsMode;
+        m_ParamsOCR.cls_thresh = m_OCRParam.clsThresh;
+        m_ParamsOCR.charset = m_OCRParam.recCharset.empty() ? nullptr : m_OCRParam.recCharset.c_str();
         if (m_paddleOcr->setparms(m_ParamsOCR) == 0) {
             m_logger->logError("OCR 字典文件加载失败，请检查配置文件中的字典路径", false);
             return;
         }
+        std::variant<bool, std::string> init_status = m_paddleOcr->initialize(onnx_paths, true, ocr_threads);
+        if (init_status.index() == 1) { 
+            std::string error_message = std::get<std::string>(init_status);
+            m_logger->logError(fmt::format("OCR模型初始化失败: {}", error_message), false);
+            return; 
+        }
+        if (ocr_threads.global_pool && !m_paddleOcr->uses_global_pool()) {
+            m_logger->logWarn("ONNX Runtime 环境已在OCR之前以无全局线程池方式创建，OCR改用各会话独立线程池", false);
+        }
+        m_logger->logInfo(fmt::format("OCR 引擎初始化成功!"), false);
+        // 检测模型在OCR之后创建：CPU 后端与OCR共用进程内唯一的 Ort::Env，需由OCR按其线程配置先创建
+        m_detector = std::make_unique<deploy::DetectModel>(m_GlobalParam.modelPath, option);
     }
 
     if (!m_detector) {
@@ -75,19 +104,34 @@ ThreadManager::ThreadManager(QObject *parent)
                 m_detector->predict(warmup_img);
             }
             m_logger->logInfo("YOLO模型预热完成。", false);
+            // 丢弃预热期间的统计
+            m_detector->getPerformanceReport();
         } catch (const std::exception& e) {
             m_logger->logError(fmt::format("YOLO模型预热失败: {}", e.what()), false);
             return;
         }
+
+        // 引擎支持多batch时，所有任务线程的拼接图汇聚到批处理器统一推理；
+        // 否则为每个任务线程克隆检测模型，多个过车任务并行处理
+        m_taskWorkers = (std::max)(1, m_GlobalParam.maxConcurrentTasks);
+        if (m_detector->batch_size() > 1) {
+            m_detectBatcher = std::make_unique<DetectBatcher>(m_detector->clone(), m_GlobalParam.batchTimeoutMs);
+            m_logger->logInfo(fmt::format("启用批量检测: batch {}, 等待上限 {} ms", m_detectBatcher->batchSize(), m_GlobalParam.batchTimeoutMs), false);
+        } else {
+            for (int i = 0; i < m_taskWorkers; ++i) {
+                m_workerDetectors.emplace_back(m_detector->clone());
+            }
+        }
+        m_logger->logInfo(fmt::format("并行任务数: {}", m_taskWorkers), false);
     }
 }
 
 ThreadManager::~ThreadManager() {
     stopThreads();
     m_udpTool->Close();
+    m_detectBatcher.reset();
+    m_workerDetectors.clear();
     m_detector.reset();
-    m_trainParser.reset();
-    m_trainNumberDetector.reset();
     m_paddleOcr.reset();
     m_logger->logInfo("线程管理器已销毁", false);
     emit m_Logs(QString("线程管理器已销毁"));
@@ -96,12 +140,19 @@ ThreadManager::~ThreadManager() {
 void ThreadManager::startThreads() {
     // 启动线程
     if (m_udpTool)  m_threads.emplace_back(std::make_shared<std::thread>(&ThreadManager::UdpToolRecvMessage, this));     
-    m_threads.emplace_back(std::make_shared<std::thread>(&ThreadManager::UdpProcessMessage, this));
+    for (int i = 0; i < m_taskWorkers; ++i) {
+        m_threads.emplace_back(std::make_shared<std::thread>(&ThreadManager::UdpProcessMessage, this, i));
+    }
     m_threads.emplace_back(std::make_shared<std::thread>(&ThreadManager::PicProcessThread, this));
+    if (m_GlobalParam.streamingMode) {
+        m_threads.emplace_back(std::make_shared<std::thread>(&ThreadManager::StreamWatchThread, this));
+    }
 }
 
 void ThreadManager::stopThreads() {
     threadStop = true;
+    m_queue_udpTool->close();
+    m_queue_picProcess->close();
     for (auto &thread : m_threads) {
         if (thread->joinable()) {
             thread->join();
@@ -120,6 +171,7 @@ bool ThreadManager::UdpToolRecvMessage() {
     }
     m_udpTool->SetRecvTimeout(1);
     m_udpTool->SetSendTimeout(1);
+    const std::regex msg_regex(R"(\{BC\}&(\d+)&(105-x)&(.*))");
     emit m_Logs(QString("接收消息线程启动"));
     m_logger->logInfo(fmt::format("接收消息线程启动"), false);
     while (!threadStop) {
@@ -147,11 +199,50 @@ bool ThreadManager::UdpToolRecvMessage() {
                 if(!isDuplicate) {
                     // 更新任务记录
                     lastTask = TaskRecord{currentMsg, now};
-                    
+
+                    // 流式接入时，UDP消息是对应过车目录的结束信号
+                    if (m_GlobalParam.streamingMode) {
+                        std::smatch match;
+                        if (std::regex_match(currentMsg, match, msg_regex)) {
+                            std::string timestamp = match[1].str();
+                            std::shared_ptr<StreamState> stream;
+                            bool finished = false;
+                            {
+                                std::lock_guard<std::mutex> lock(m_streamMutex);
+                                auto it = m_streams.find(timestamp);
+                                if (it != m_streams.end()) {
+                                    stream = it->second;
+                                    m_streams.erase(it);
+                                    rememberFinishedStream(timestamp);
+                                } else if (std::find(m_finishedStreams.begin(), m_finishedStreams.end(), timestamp) != m_finishedStreams.end()) {
+                                    // 流式任务已超时结束并输出结果，迟到的结束消息不再整目录处理
+                                    finished = true;
+                                } else if (timestamp.size() > m_latestStream.size() ||
+                                           (timestamp.size() == m_latestStream.size() && timestamp > m_latestStream)) {
+                                    // 监听线程尚未发现该目录，按整目录处理，避免重复接入
+                                    m_latestStream = timestamp;
+                                }
+                            }
+                            if (stream) {
+                                stream->ended = true;
+                                m_logger->logInfo(fmt::format("流式任务收到过车结束消息: {}", currentMsg), false);
+                                emit m_Logs(QString("流式任务收到过车结束消息: %1").arg(currentMsg.c_str()));
+                                continue;
+                            }
+                            if (finished) {
+                                m_logger->logInfo(fmt::format("流式任务已结束，忽略过车结束消息: {}", currentMsg), false);
+                                emit m_Logs(QString("流式任务已结束，忽略过车结束消息: %1").arg(currentMsg.c_str()));
+                                continue;
+                            }
+                        }
+                    }
+
                     // 处理新任务
-                    m_mtx_udpTool->lock();
-                    m_queue_udpTool.emplace(currentMsg);
-                    m_mtx_udpTool->unlock();
+                    if (!m_queue_udpTool->push(TaskRequest{currentMsg, nullptr})) {
+                        m_logger->logError(fmt::format("任务队列已满，丢弃任务: {}", currentMsg), false);
+                        emit m_Logs(QString("任务队列已满，丢弃任务: %1").arg(currentMsg.c_str()));
+                        continue;
+                    }
     
                     emit m_Logs(QString("接收到的数据: %1").arg(currentMsg.c_str()));
                     m_logger->logInfo(fmt::format("接收到的数据: {}", currentMsg), false);
@@ -169,177 +260,52 @@ bool ThreadManager::UdpToolRecvMessage() {
     return true;
 }
 
-bool ThreadManager::UdpProcessMessage(){
+bool ThreadManager::UdpProcessMessage(int workerId){
 
-    emit m_Logs (QString("处理消息线程启动"));
-    m_logger->logInfo(fmt::format("处理消息线程启动"), false);
+    emit m_Logs (QString("处理消息线程 %1 启动").arg(workerId));
+    m_logger->logInfo(fmt::format("处理消息线程 {} 启动", workerId), false);
     while(!threadStop) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
-        m_mtx_udpTool->lock();
-        if (!m_queue_udpTool.empty()) {
-            std::string msg = m_queue_udpTool.front();
-            m_queue_udpTool.pop();
-            m_mtx_udpTool->unlock();
-            // Message format: {BC}&timestamp&105-x&any_char
-            std::regex msg_regex(R"(\{BC\}&(\d+)&(105-x)&(.*))");
-            std::smatch match;
-            if (std::regex_match(msg, match, msg_regex)) {
-                if (match.size() == 4) {
-                    std::string timestamp = match[1].str();
-                    std::string channel_info = match[2].str(); 
-                    // std::string any_char = match[3].str(); 
-
-                    if (channel_info.rfind("105-x", 0) == 0) { 
-                        m_logger->logInfo(fmt::format("有效消息格式: 时间戳 {}, 通道 {}", timestamp, channel_info), false);
-                        emit m_Logs(QString("有效消息格式: 时间戳 %1, 通道 %2").arg(timestamp.c_str()).arg(channel_info.c_str()));
-
-                        std::filesystem::path image_base_path = m_GlobalParam.imagePath;
-                        std::filesystem::path image_folder_path = image_base_path / timestamp;
-
-                        m_logger->logInfo(fmt::format("图片文件夹路径: {}", image_folder_path.string()), false);
-
-                        std::vector<std::filesystem::path> image_files;
-                        // std::regex file_regex_pattern(R"(105-(\d{3})-x\.jpg");
-                        std::regex file_regex_pattern(R"(^105-(\d{3})-x\.jpg$)");
-
-                        if (std::filesystem::exists(image_folder_path) && std::filesystem::is_directory(image_folder_path)) {
-                            for (const auto& entry : std::filesystem::directory_iterator(image_folder_path)) {
-                                if (entry.is_regular_file()) {
-                                    std::string filename = entry.path().filename().string();
-                                    if (std::regex_match(filename, file_regex_pattern)) {
-                                        image_files.push_back(entry.path());
-                                    }
-                                }
-                            }
+        TaskRequest request;
+        if (!m_queue_udpTool->pop(request, std::chrono::milliseconds(100))) {
+            continue;
+        }
+        // 流式接入发现的过车目录，图片仍在写入
+        if (request.stream) {
+            runTask(workerId, request.stream->timestamp, request.stream);
+            continue;
+        }
 
-                            std::sort(image_files.begin(), image_files.end(),
-                                      [&](const std::filesystem::path& a, const std::filesystem::path& b) {
-                                          std::smatch sm_a, sm_b;
-                                          std::string fn_a = a.filename().string();
-                                          std::string fn_b = b.filename().string();
-                                          std::regex_search(fn_a, sm_a, file_regex_pattern);
-                                          std::regex_search(fn_b, sm_b, file_regex_pattern);
-                                          return std::stoi(sm_a[1].str()) < std::stoi(sm_b[1].str());
-                                      });
-
-                            m_logger->logInfo(fmt::format("找到并排序 {} 个105通道图片文件", image_files.size()), false);
-                            
-                            int totalGroups = (image_files.size() >= 3) ? (image_files.size() - 2) : 0;
-                            emit m_UpdateProgress(0, totalGroups);
-                            emit m_UpdateCurrentGroup(QString("开始处理图片组"));
-
-                            if (image_files.size() >= 3) {
-                                for (size_t i = 0; i <= image_files.size() - 3; ++i) {
-                                    if (threadStop) break; 
-
-                                    std::vector<std::future<cv::Mat>> image_futures;
-                                    for (int j = 0; j < 3; ++j) {
-                                        image_futures.push_back(std::async(std::launch::async, [&, j]() {
-                                            return cv::imread(image_files[i + j].string());
-                                        }));
-                                    }
-                                    
-                                    // 获取加载结果
-                                    cv::Mat img1 = image_futures[0].get();
-                                    cv::Mat img2 = image_futures[1].get();
-                                    cv::Mat img3 = image_futures[2].get();
-
-                                    // cv::Mat img1 = cv::imread(image_files[i].string());
-                                    // cv::Mat img2 = cv::imread(image_files[i + 1].string());
-                                    // cv::Mat img3 = cv::imread(image_files[i + 2].string());
-
-                                    if (img1.empty() || img2.empty() || img3.empty()) {
-                                        m_logger->logError(fmt::format("无法加载用于拼接的图片: {} 或 {} 或 {}", 
-                                            image_files[i].string(), image_files[i+1].string(), image_files[i+2].string()), false);
-                                        continue;
-                                    }
-                                    cv::Mat resized_image = getStitchImageOptimized(img1,img2,img3, m_GlobalParam.factor, 
-                                                                           cv::Size(m_GlobalParam.resizeWidth,
-                                                                           m_GlobalParam.reiszeHeight));
-
-                                    // 把图像高度去除一般保留下半部分图片
-                                    int half_height = resized_image.rows / 2;
-                                    cv::Rect roi(0, half_height, resized_image.cols, half_height);
-                                    cv::Mat cropped_image = resized_image(roi);
-
-                                    StitchedImageData data;
-                                    data.image = cropped_image;
-                                    data.timestamp = timestamp;
-                                    
-                                    std::smatch seq_match;
-                                    std::string first_img_filename = image_files[i].filename().string();
-                                    if(std::regex_search(first_img_filename, seq_match, file_regex_pattern) && seq_match.size() > 1) {
-                                        data.imageSequenceNumber = seq_match[1].str();
-                                    } else {
-                                        data.imageSequenceNumber = std::to_string(i); 
-                                    }
-                                    // 0 开始 1 中间 2 结束
-                                    int total_stitched_images = image_files.size() - 2;
-                                    if (i == 0) {
-                                        data.flag = 0; 
-                                    }
-                                    if (i == total_stitched_images -1 ) { 
-                                        data.flag = (data.flag == 0 && total_stitched_images == 1) ? 0 : 2; 
-                                        if (total_stitched_images > 1 && i == total_stitched_images -1) data.flag = 2; 
-                                            else if (total_stitched_images == 1) data.flag = 0; 
-                                    }
-                                    else if (i > 0 && i < total_stitched_images -1) {
-                                        data.flag = 1; 
-                                    }
-                                    
-                                    if (total_stitched_images == 1) { 
-                                        data.flag = 0; 
-                                    } else if (i == 0) {
-                                        data.flag = 0; 
-                                    } else if (i == total_stitched_images - 1) {
-                                        data.flag = 2; 
-                                    } else {
-                                        data.flag = 1; 
-                                    }
-
-                                    m_mtx_picProcess->lock();
-                                    m_queue_picProcess.push(data);
-                                    m_mtx_picProcess->unlock();
-
-                                    m_logger->logInfo(fmt::format("已拼接并推送图片: 序号 {}, 时间戳 {}, 标志 {}", data.imageSequenceNumber, data.timestamp, data.flag), false);
-                                    emit m_Logs(QString("已拼接图片: 序号 %1, 时间戳 %2, 标志 %3").arg(data.imageSequenceNumber.c_str()).arg(data.timestamp.c_str()).arg(data.flag));
-                                    
-                                    // 更新进度条和当前处理组信息
-                                    emit m_UpdateProgress(i + 1, image_files.size() - 2);
-                                    emit m_UpdateCurrentGroup(QString("正在处理图片组: %1/%2").arg(i + 1).arg(image_files.size() - 2));
-                                }
-                            } else {
-                                m_logger->logError(fmt::format("图片数量不足3张无法拼接，在目录: {}", image_folder_path.string()), false);
-                                emit m_Logs(QString("图片数量不足3张无法拼接于目录: %1").arg(image_folder_path.string().c_str()));
-                                emit m_UpdateProgress(0, 0);
-                                emit m_UpdateCurrentGroup(QString("无法处理：图片数量不足"));
-                            }
-                        } else {
-                            m_logger->logError(fmt::format("图片文件夹不存在或不是目录: {}", image_folder_path.string()), false);
-                            emit m_Logs(QString("图片文件夹不存在: %1").arg(image_folder_path.string().c_str()));
-                            emit m_UpdateProgress(0, 0);
-                            emit m_UpdateCurrentGroup(QString("无法处理：文件夹不存在"));
-                        }
-                    } else {
-                        m_logger->logError(fmt::format("接收到消息但通道非105-x: {}", msg), false);
-                        emit m_Logs(QString("接收到消息但通道非105-x: %1").arg(msg.c_str()));
-                        emit m_UpdateProgress(0, 0);
-                        emit m_UpdateCurrentGroup(QString("无法处理：通道错误"));
-                    }
+        const std::string& msg = request.message;
+        // Message format: {BC}&timestamp&105-x&any_char
+        std::regex msg_regex(R"(\{BC\}&(\d+)&(105-x)&(.*))");
+        std::smatch match;
+        if (std::regex_match(msg, match, msg_regex)) {
+            if (match.size() == 4) {
+                std::string timestamp = match[1].str();
+                std::string channel_info = match[2].str(); 
+                // std::string any_char = match[3].str(); 
+
+                if (channel_info.rfind("105-x", 0) == 0) { 
+                    m_logger->logInfo(fmt::format("有效消息格式: 时间戳 {}, 通道 {}", timestamp, channel_info), false);
+                    emit m_Logs(QString("有效消息格式: 时间戳 %1, 通道 %2").arg(timestamp.c_str()).arg(channel_info.c_str()));
+                    runTask(workerId, timestamp, nullptr);
                 } else {
-                    m_logger->logError(fmt::format("无效消息格式 (无法解析): {}", msg), false);
-                    emit m_Logs(QString("无效消息格式 (无法解析): %1").arg(msg.c_str()));
+                    m_logger->logError(fmt::format("接收到消息但通道非105-x: {}", msg), false);
+                    emit m_Logs(QString("接收到消息但通道非105-x: %1").arg(msg.c_str()));
                     emit m_UpdateProgress(0, 0);
-                    emit m_UpdateCurrentGroup(QString("无法处理：消息格式无效"));
+                    emit m_UpdateCurrentGroup(QString("无法处理：通道错误"));
                 }
             } else {
-                m_logger->logError(fmt::format("接收到消息但不匹配指定格式: {}", msg), false);
-                emit m_Logs(QString("处理消息: %1 (格式不匹配)").arg(msg.c_str()));
+                m_logger->logError(fmt::format("无效消息格式 (无法解析): {}", msg), false);
+                emit m_Logs(QString("无效消息格式 (无法解析): %1").arg(msg.c_str()));
                 emit m_UpdateProgress(0, 0);
-                emit m_UpdateCurrentGroup(QString("无法处理：消息格式不匹配"));
+                emit m_UpdateCurrentGroup(QString("无法处理：消息格式无效"));
             }
         } else {
-            m_mtx_udpTool->unlock();
+            m_logger->logError(fmt::format("接收到消息但不匹配指定格式: {}", msg), false);
+            emit m_Logs(QString("处理消息: %1 (格式不匹配)").arg(msg.c_str()));
+            emit m_UpdateProgress(0, 0);
+            emit m_UpdateCurrentGroup(QString("无法处理：消息格式不匹配"));
         }
     }
     m_logger->logInfo("处理消息线程退出", false);
@@ -347,160 +313,516 @@ bool ThreadManager::UdpProcessMessage(){
 
 }
 
-bool ThreadManager::PicProcessThread() {
-    emit m_Logs(QString("图片处理线程启动"));
-    m_logger->logInfo(fmt::format("图片处理线程启动"), false);
+void ThreadManager::runTask(int workerId, const std::string& timestamp, const std::shared_ptr<StreamState>& stream) {
+    std::filesystem::path image_base_path = m_GlobalParam.imagePath;
+    std::filesystem::path image_folder_path = image_base_path / timestamp;
+
+    m_logger->logInfo(fmt::format("图片文件夹路径: {}", image_folder_path.string()), false);
+
+    if (!std::filesystem::exists(image_folder_path) || !std::filesystem::is_directory(image_folder_path)) {
+        m_logger->logError(fmt::format("图片文件夹不存在或不是目录: {}", image_folder_path.string()), false);
+        emit m_Logs(QString("图片文件夹不存在: %1").arg(image_folder_path.string().c_str()));
+        emit m_UpdateProgress(0, 0);
+        emit m_UpdateCurrentGroup(QString("无法处理：文件夹不存在"));
+        return;
+    }
+
+    std::regex file_regex_pattern(R"(^105-(\d{3})-x\.jpg$)");
+
+    // 已发现的图片，按序号排序。流式任务中相机按序号依次写入，新图片追加在末尾；
+    // 解码在预取线程中进行，读取路径需加锁
+    std::deque<std::filesystem::path> image_files;
+    std::vector<std::string> image_seqs;
+    std::mutex files_mutex;
+    int last_seq = -1;
+    auto scanFiles = [&]() -> size_t {
+        std::vector<std::pair<int, std::filesystem::path>> found;
+        std::error_code ec;
+        for (const auto& entry : std::filesystem::directory_iterator(image_folder_path, ec)) {
+            if (entry.is_regular_file(ec)) {
+                std::string filename = entry.path().filename().string();
+                std::smatch sm;
+                if (std::regex_match(filename, sm, file_regex_pattern)) {
+                    int seq = std::stoi(sm[1].str());
+                    if (seq > last_seq) {
+                        found.emplace_back(seq, entry.path());
+                    }
+                }
+            }
+        }
+        std::sort(found.begin(), found.end(),
+                  [](const auto& a, const auto& b) { return a.first < b.first; });
+
+        std::lock_guard<std::mutex> lock(files_mutex);
+        for (auto& f : found) {
+            image_seqs.push_back(f.second.filename().string().substr(4, 3));
+            image_files.push_back(std::move(f.second));
+            last_seq = f.first;
+        }
+        return found.size();
+    };
+
+    std::unique_ptr<TaskContext> ctx = createTaskContext(timestamp);
+    size_t processed = 0;
+
+    // 批处理时已提交检测、尚未处理的拼接图，最多保持一个batch在途，按序号顺序处理结果
+    // 检测结果槽位按提交顺序轮转复用，在途数小于槽位数，新提交的槽位总是已处理完的
+    struct InflightFrame {
+        StitchedImageData data;
+        deploy::DetectRes* result;
+        std::future<void> done;
+    };
+    std::deque<InflightFrame> inflight;
+    size_t max_inflight = m_detectBatcher ? static_cast<size_t>(m_detectBatcher->batchSize()) : 1;
+    std::vector<deploy::DetectRes> inflightResults(max_inflight);
+    size_t submitted = 0;
+    auto processFront = [&]() {
+        auto& front = inflight.front();
+        try {
+            front.done.get();
+            processFrame(*ctx, front.data, *front.result);
+            ++processed;
+        } catch (const std::exception& e) {
+            m_logger->logError(fmt::format("拼接图检测失败: 序号 {}, {}", front.data.imageSequenceNumber, e.what()), false);
+        }
+        inflight.pop_front();
+    };
+    // 未启用批处理时在本线程直接推理，检测结果逐帧复用容量
+    deploy::DetectRes detection;
+    auto processDirect = [&](const StitchedImageData& data) {
+        try {
+            detect(workerId, data.image, detection);
+            processFrame(*ctx, data, detection);
+            ++processed;
+        } catch (const std::exception& e) {
+            m_logger->logError(fmt::format("拼接图检测失败: 序号 {}, {}", data.imageSequenceNumber, e.what()), false);
+        }
+    };
+
+    ImageStitcher stitcher(cv::Size(m_GlobalParam.resizeWidth, m_GlobalParam.reiszeHeight),
+                           m_GlobalParam.stitchBandTop, m_GlobalParam.stitchBandBottom);
+    stitcher.setDecodeScale(m_GlobalParam.decodeScale);
+
+    // 滑动窗口缓存：拼接窗口3张 + 预取1张，每张图片只解码并缩放一次
+    FrameCache frameCache(4, [&image_files, &files_mutex, &stitcher](size_t idx) {
+        std::filesystem::path path;
+        {
+            std::lock_guard<std::mutex> lock(files_mutex);
+            path = image_files[idx];
+        }
+        return stitcher.loadTile(path.string());
+    });
+
+    // 流式任务监听目录，等待新图片写入
+    std::unique_ptr<DirectoryWatcher> watcher;
+    if (stream) {
+        watcher = std::make_unique<DirectoryWatcher>(image_folder_path.string());
+        m_logger->logInfo(fmt::format("流式任务开始: 时间戳 {}, 目录监听{}", timestamp, watcher->isNotifying() ? "" : "不可用，改为轮询"), false);
+        emit m_Logs(QString("流式任务开始: 时间戳 %1").arg(timestamp.c_str()));
+    }
+    emit m_UpdateProgress(0, 0);
+    emit m_UpdateCurrentGroup(QString("开始处理图片组"));
+
+    const auto idle_timeout = std::chrono::seconds((std::max)(1, m_GlobalParam.streamIdleTimeoutSec));
+    auto last_arrival = std::chrono::steady_clock::now();
+    size_t next = 0;        // 下一个拼接窗口的起始序号
+    bool ended = false;
     while (!threadStop) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(10)); 
-        m_mtx_picProcess->lock();
-        if (!m_queue_picProcess.empty()) {
-            StitchedImageData data = m_queue_picProcess.front();
-            m_queue_picProcess.pop();
-            m_mtx_picProcess->unlock();
-
-            if (data.flag == 0) {
-                emit m_ShowString("正在处理图片中...");
-                trianNums.clear();
-                trianString.clear();
-                trainNumCount = 0;
-                m_trainNumberDetector->lastReportedNumber.clear();
+        // 先读取结束标志再扫描，结束前写入的图片都能被本次扫描发现
+        ended = !stream || stream->ended.load();
+        if (scanFiles() > 0) {
+            last_arrival = std::chrono::steady_clock::now();
+        }
+        if (!ended && std::chrono::steady_clock::now() - last_arrival > idle_timeout) {
+            m_logger->logWarn(fmt::format("流式任务 {} 秒无新图片且未收到结束消息，按过车结束处理: {}", idle_timeout.count(), timestamp), false);
+            ended = true;
+        }
+
+        size_t total = 0;
+        {
+            std::lock_guard<std::mutex> lock(files_mutex);
+            total = image_files.size();
+        }
+        // 过车未结束时，最新一张可能仍在写入，出现下一张后才视为完整
+        size_t ready = ended ? total : (total > 0 ? total - 1 : 0);
+        size_t groups = (total >= 3) ? (total - 2) : 0;
+
+        for (; next + 3 <= ready; ++next) {
+            if (threadStop) break;
+
+            // 预取下一个窗口新增的图片，与当前拼接/检测并行解码
+            if (next + 3 < ready) {
+                frameCache.prefetch(next + 3);
             }
 
-            m_logger->logInfo(fmt::format("处理拼接图片: 序号 {}, 时间戳 {}, 标志 {}", data.imageSequenceNumber, data.timestamp, data.flag), false);
-            emit m_Logs(QString("处理拼接图片: 序号 %1, 时间戳 %2, 标志 %3").arg(data.imageSequenceNumber.c_str()).arg(data.timestamp.c_str()).arg(data.flag));
+            // 获取加载结果
+            cv::Mat img1 = frameCache.get(next);
+            cv::Mat img2 = frameCache.get(next + 1);
+            cv::Mat img3 = frameCache.get(next + 2);
 
-            if (data.image.empty()) {
-                m_logger->logError(fmt::format("当前图像为空，无法处理"), false);
-                emit m_Logs(QString("当前图像为空，无法处理"));
+            if (img1.empty() || img2.empty() || img3.empty()) {
+                std::lock_guard<std::mutex> lock(files_mutex);
+                m_logger->logError(fmt::format("无法加载用于拼接的图片: {} 或 {} 或 {}", 
+                    image_files[next].string(), image_files[next + 1].string(), image_files[next + 2].string()), false);
                 continue;
             }
-            
-            std::string currentTrianNum, extraTrainNum;
-            deploy::Image stitched_image(data.image.data, data.image.cols, data.image.rows);
-            deploy::DetectRes yolo_detection_result = m_detector->predict(stitched_image);
-           
-            if (m_GlobalParam.recMode == 0) {
-                currentTrianNum = getCurrentNum(yolo_detection_result, m_labels, data.image.cols, data.image.rows, 5.0);
+            // 拼接图只包含配置的保留区域（默认下半部分）
+            cv::Mat cropped_image = stitcher.stitch(img1, img2, img3);
+
+            StitchedImageData data;
+            data.image = cropped_image;
+            data.timestamp = timestamp;
+            {
+                std::lock_guard<std::mutex> lock(files_mutex);
+                data.imageSequenceNumber = image_seqs[next];
             }
-            else if (m_GlobalParam.recMode == 1) {
-                std::vector<std::string> ocrTexts;
-                auto filterBoxes = preprocess_detection_result(yolo_detection_result, data.image.cols, data.image.rows);
-                std::vector<PaddleOCR::YoloDetectionBox> custom_boxes_for_ocr;
-                for (size_t i = 0; i < filterBoxes.num; ++i) {
-                    const deploy::Box& y_box = filterBoxes.boxes[i];
-                    PaddleOCR::YoloDetectionBox ocr_box;
-                    ocr_box.left = y_box.left;
-                    ocr_box.top = y_box.top;
-                    ocr_box.right = y_box.right;
-                    ocr_box.bottom = y_box.bottom;
-                    ocr_box.score = filterBoxes.scores[i];
-                    custom_boxes_for_ocr.push_back(ocr_box);
-                }
-                auto ocr_processing_result = m_paddleOcr->inference_from_custom_boxes(data.image, custom_boxes_for_ocr, ocrTexts);
-                if (ocrTexts.size() == 0) {
-                    currentTrianNum = "";
-                }
-                else {
-                    currentTrianNum = ocrTexts[0];
-                }
+            // 0 开始 1 中间 2 结束
+            if (next == 0) {
+                data.flag = 0;
+            } else if (ended && next + 3 == ready) {
+                data.flag = 2;
+            } else {
+                data.flag = 1;
             }
-            
-            // 保存识别图像
-            if (m_GlobalParam.isSave) {
-                std::string save_path = m_GlobalParam.savePath + data.timestamp + "\\";
-                if (!std::filesystem::exists(save_path)) {
-                    std::filesystem::create_directories(save_path);
-                    emit m_Logs(QString("创建保存目录：%1成功").arg(save_path.c_str()));
-                    m_logger->logInfo(fmt::format("创建保存目录：{}成功", save_path), false);
-                }
-                
-                // visualize(data.image, yolo_detection_result, m_labels);
-                if(currentTrianNum.length() > 0) {
-                    std::string saveFile = save_path + data.imageSequenceNumber + ".jpg";
-                    cv::imwrite(saveFile, data.image);
+
+            // 当前任务的拼接图在本线程提交检测，下一帧的解码已在后台进行
+            if (m_detectBatcher) {
+                deploy::DetectRes& slot = inflightResults[submitted++ % max_inflight];
+                inflight.push_back(InflightFrame{data, &slot,
+                                                 m_detectBatcher->submit(deploy::Image(data.image.data, data.image.cols, data.image.rows), slot)});
+                while (inflight.size() >= max_inflight) {
+                    processFront();
                 }
+            } else {
+                processDirect(data);
             }
 
-            m_trainNumberDetector->processFrame(currentTrianNum, extraTrainNum);
+            // 更新进度条和当前处理组信息
+            emit m_UpdateProgress(static_cast<int>(next + 1), static_cast<int>(groups));
+            emit m_UpdateCurrentGroup(QString("正在处理图片组: %1/%2").arg(next + 1).arg(groups));
+        }
+
+        if (ended) {
+            break;
+        }
+        // 流式任务中已完成的拼接图先出结果，不等凑满batch
+        while (!inflight.empty()) {
+            processFront();
+        }
+        watcher->waitForChange(std::chrono::milliseconds(200));
+    }
+
+    while (!inflight.empty()) {
+        processFront();
+    }
+
+    if (stream) {
+        std::lock_guard<std::mutex> lock(m_streamMutex);
+        auto it = m_streams.find(timestamp);
+        if (it != m_streams.end() && it->second == stream) {
+            m_streams.erase(it);
+        }
+        rememberFinishedStream(timestamp);
+    }
+
+    if (threadStop) {
+        return;
+    }
+    if (next == 0) {
+        m_logger->logError(fmt::format("图片数量不足3张无法拼接，在目录: {}", image_folder_path.string()), false);
+        emit m_Logs(QString("图片数量不足3张无法拼接于目录: %1").arg(image_folder_path.string().c_str()));
+        emit m_UpdateProgress(0, 0);
+        emit m_UpdateCurrentGroup(QString("无法处理：图片数量不足"));
+        return;
+    }
+    if (processed > 0) {
+        m_logger->logInfo(fmt::format("任务处理结束: 时间戳 {}, 共 {} 组", timestamp, processed), false);
+        emit m_Logs(QString("任务处理结束: 时间戳 %1").arg(timestamp.c_str()));
+        finishTask(*ctx);
+        if (!m_detectBatcher) {
+            logPerformanceReport(*m_workerDetectors[workerId], timestamp);
+        }
+    }
+}
+
+void ThreadManager::rememberFinishedStream(const std::string& timestamp) {
+    if (std::find(m_finishedStreams.begin(), m_finishedStreams.end(), timestamp) != m_finishedStreams.end()) {
+        return;
+    }
+    m_finishedStreams.push_back(timestamp);
+    if (m_finishedStreams.size() > FINISHED_STREAM_HISTORY) {
+        m_finishedStreams.pop_front();
+    }
+}
+
+bool ThreadManager::StreamWatchThread() {
+    std::filesystem::path image_base_path = m_GlobalParam.imagePath;
+    if (!std::filesystem::is_directory(image_base_path)) {
+        m_logger->logError(fmt::format("流式接入图片根目录不存在: {}", image_base_path.string()), false);
+        emit m_Logs(QString("流式接入图片根目录不存在: %1").arg(image_base_path.string().c_str()));
+        return false;
+    }
 
-            if (!extraTrainNum.empty()) {
-                m_logger->logInfo(fmt::format("识别到车号: {}", extraTrainNum), false);
-                emit m_Logs(QString("识别到车号: %1").arg(extraTrainNum.c_str()));
-                trainNumCount++;
-                trianString.append(FileTools::getInstance().str_format("#%d&%s", trainNumCount, extraTrainNum.c_str()));
-                trianNums.push_back(extraTrainNum);
+    // 时间戳目录名为定长数字，先比较长度再按字典序比较
+    auto isNewer = [](const std::string& a, const std::string& b) {
+        return a.size() != b.size() ? a.size() > b.size() : a > b;
+    };
+    auto listTaskDirs = [&]() {
+        std::vector<std::string> dirs;
+        std::error_code ec;
+        for (const auto& entry : std::filesystem::directory_iterator(image_base_path, ec)) {
+            if (!entry.is_directory(ec)) continue;
+            std::string name = entry.path().filename().string();
+            if (!name.empty() && std::all_of(name.begin(), name.end(), [](unsigned char c) { return std::isdigit(c); })) {
+                dirs.push_back(name);
             }
+        }
+        std::sort(dirs.begin(), dirs.end(), [&](const std::string& a, const std::string& b) { return isNewer(b, a); });
+        return dirs;
+    };
+
+    // 启动前已存在的目录不接入，仍由UDP消息触发整目录处理
+    {
+        std::vector<std::string> existing = listTaskDirs();
+        std::lock_guard<std::mutex> lock(m_streamMutex);
+        if (!existing.empty() && isNewer(existing.back(), m_latestStream)) {
+            m_latestStream = existing.back();
+        }
+    }
 
-            if (data.flag == 2) {
-                // 结束标志
-                m_logger->logInfo(fmt::format("处理结束标志: 序号 {}, 时间戳 {}, 标志 {}", data.imageSequenceNumber, data.timestamp, data.flag), false);
-                emit m_Logs(QString("处理结束标志: 序号 %1, 时间戳 %2, 标志 %3").arg(data.imageSequenceNumber.c_str()).arg(data.timestamp.c_str()).arg(data.flag));
-                
-                // 初始化车号结果
-                std::string trainPlants, trianDiretion, CorrectString;
-
-                if (trainNumCount == 0) {
-                    m_logger->logInfo(fmt::format("当前任务未检测到车号"), false);
-                    emit m_Logs(QString("当前任务未检测到车号"));
-
-                    std::string msg = FileTools::getInstance().str_format("{CHJG}&%s&2&0&NULL&0&NULL", data.timestamp.c_str());
-                    // 发送消息
-                    emit m_ShowString(msg);
-                    m_udpTool->Send(msg.c_str(), msg.size(),m_udpToolParam.send_ip, m_udpToolParam.send_port);
-                    m_logger->logInfo(fmt::format("发送消息: {}", msg), false);
-                    emit m_Logs(QString("发送消息: %1").arg(msg.c_str()));
-                }
-                else {
-
-                    switch (m_AlgParam.trian_type) {
-                        case 0:
-                            m_logger->logInfo(fmt::format("地铁纯数字车号识别结果"), false);
-                            emit m_Logs(QString("地铁纯数字车号识别结果"));
-                            m_MetrotrainParser->parse(trianString);
-                            trainPlants = m_MetrotrainParser->getTrainNumber();
-                            trianDiretion = m_MetrotrainParser->getDirection();
-                            CorrectString = m_MetrotrainParser->getCorrectedInput();
-                            break;
-                        case 1:
-                            trainPlants = "N/A";
-                            trianDiretion = "N/A";
-                            CorrectString = trianString;
-                            break;
-                        case 2:
-                            m_logger->logInfo(fmt::format("高铁车号识别结果"), false);
-                            emit m_Logs(QString("高铁车号识别结果"));
-                            m_trainParser->parse(trianString);
-                            trainPlants = m_trainParser->getTrainNumber();
-                            trianDiretion = m_trainParser->getDirection();
-                            CorrectString = m_trainParser->getCorrectedInput();
-                            break;
-                        default:
-                            m_logger->logInfo(fmt::format("未配置车型，请在配置文件中配置车型"), false);
-                            emit m_Logs(QString("未配置车型，请在配置文件中配置车型"));
-                            trainPlants = "N/A";
-                            trianDiretion = "N/A";
-                            CorrectString = trianString;
-                            break;
-                    }
-                    
-                    std::string msg = FileTools::getInstance().str_format("{CHJG}&%s&2&%s&%s&%d&%s", data.timestamp.c_str(),
-                                      trianDiretion.c_str(), trainPlants.c_str(), trainNumCount, CorrectString.c_str() );
-                    emit m_ShowString(msg);
-                    // 发送消息
-                    m_udpTool->Send(msg.c_str(), msg.size(),m_udpToolParam.send_ip, m_udpToolParam.send_port);
-                    m_logger->logInfo(fmt::format("当前任务识别完成，发送消息: {}", msg), false);
-                    emit m_Logs(QString("当前任务识别完成，发送消息: %1").arg(msg.c_str()));
-                }
+    DirectoryWatcher watcher(image_base_path.string());
+    emit m_Logs(QString("流式接入监听线程启动"));
+    m_logger->logInfo(fmt::format("流式接入监听线程启动: {}, 目录监听{}", image_base_path.string(), watcher.isNotifying() ? "" : "不可用，改为轮询"), false);
+    while (!threadStop) {
+        if (!watcher.waitForChange(std::chrono::milliseconds(500))) {
+            continue;
+        }
+        for (const std::string& name : listTaskDirs()) {
+            auto state = std::make_shared<StreamState>();
+            state->timestamp = name;
+            {
+                std::lock_guard<std::mutex> lock(m_streamMutex);
+                if (!isNewer(name, m_latestStream)) continue;
+                m_latestStream = name;
+                m_streams[name] = state;
+            }
+            if (!m_queue_udpTool->push(TaskRequest{std::string(), state})) {
+                std::lock_guard<std::mutex> lock(m_streamMutex);
+                m_streams.erase(name);
+                m_logger->logError(fmt::format("任务队列已满，流式任务未接入，等待UDP消息处理: {}", name), false);
+                emit m_Logs(QString("任务队列已满，流式任务未接入: %1").arg(name.c_str()));
+                continue;
             }
+            m_logger->logInfo(fmt::format("发现新过车目录，开始流式识别: {}", name), false);
+            emit m_Logs(QString("发现新过车目录，开始流式识别: %1").arg(name.c_str()));
+        }
+    }
+    m_logger->logInfo("流式接入监听线程退出", false);
+    return true;
+}
+
+bool ThreadManager::PicProcessThread() {
+    emit m_Logs(QString("图片处理线程启动"));
+    m_logger->logInfo(fmt::format("图片处理线程启动"), false);
+
+    // 手动提交的任务按时间戳区分上下文
+    std::map<std::string, std::unique_ptr<TaskContext>> tasks;
+    deploy::DetectRes detection;
+    while (!threadStop) {
+        StitchedImageData data;
+        if (!m_queue_picProcess->pop(data, std::chrono::milliseconds(100))) {
+            continue;
+        }
 
+        auto it = tasks.find(data.timestamp);
+        if (data.flag == 0 || it == tasks.end()) {
+            it = tasks.insert_or_assign(data.timestamp, createTaskContext(data.timestamp)).first;
+        }
+
+        if (data.image.empty()) {
+            m_logger->logError(fmt::format("当前图像为空，无法处理"), false);
+            emit m_Logs(QString("当前图像为空，无法处理"));
         } else {
-            m_mtx_picProcess->unlock();
+            try {
+                detect(-1, data.image, detection);
+                processFrame(*it->second, data, detection);
+            } catch (const std::exception& e) {
+                m_logger->logError(fmt::format("拼接图检测失败: 序号 {}, {}", data.imageSequenceNumber, e.what()), false);
+            }
+        }
+
+        if (data.flag == 2) {
+            // 结束标志
+            m_logger->logInfo(fmt::format("处理结束标志: 序号 {}, 时间戳 {}, 标志 {}", data.imageSequenceNumber, data.timestamp, data.flag), false);
+            emit m_Logs(QString("处理结束标志: 序号 %1, 时间戳 %2, 标志 %3").arg(data.imageSequenceNumber.c_str()).arg(data.timestamp.c_str()).arg(data.flag));
+            finishTask(*it->second);
+            if (!m_detectBatcher) {
+                logPerformanceReport(*m_detector, data.timestamp);
+            }
+            tasks.erase(it);
         }
     }
     m_logger->logInfo("图片处理线程退出", false);
     return true;
 }
 
+std::unique_ptr<ThreadManager::TaskContext> ThreadManager::createTaskContext(const std::string& timestamp) {
+    auto ctx = std::make_unique<TaskContext>();
+    ctx->timestamp = timestamp;
+    ctx->trainNumberDetector.MAX_EMPTY_FRAMES = m_AlgParam.max_empty_frames;
+    ctx->trainNumberDetector.MIN_LENGTH = m_AlgParam.min_length;
+    ctx->trainNumberDetector.TRAIN_TYPE = m_AlgParam.trian_type;
+    emit m_ShowString("正在处理图片中...");
+    return ctx;
+}
+
+void ThreadManager::detect(int workerId, const cv::Mat& image, deploy::DetectRes& result) {
+    deploy::Image stitched_image(image.data, image.cols, image.rows);
+    if (m_detectBatcher) {
+        m_detectBatcher->submit(stitched_image, result).get();
+        return;
+    }
+
+    // 未启用批处理时在调用线程上直接推理，结果写入调用方复用的 result，workerId < 0 为手动处理线程
+    deploy::DetectModel& detector = workerId < 0 ? *m_detector : *m_workerDetectors[workerId];
+    detector.predict(stitched_image, result);
+}
+
+void ThreadManager::processFrame(TaskContext& ctx, const StitchedImageData& data, deploy::DetectRes& yolo_detection_result) {
+    m_logger->logInfo(fmt::format("处理拼接图片: 序号 {}, 时间戳 {}, 标志 {}", data.imageSequenceNumber, data.timestamp, data.flag), false);
+    emit m_Logs(QString("处理拼接图片: 序号 %1, 时间戳 %2, 标志 %3").arg(data.imageSequenceNumber.c_str()).arg(data.timestamp.c_str()).arg(data.flag));
+
+    std::string currentTrianNum, extraTrainNum;
+
+    if (m_GlobalParam.recMode == 0) {
+        currentTrianNum = getCurrentNum(yolo_detection_result, m_labels, data.image.cols, data.image.rows, 5.0);
+    }
+    else if (m_GlobalParam.recMode == 1) {
+        // 识别结果写入任务内复用的缓冲区，字符串容量逐帧保留
+        std::vector<std::string>& ocrTexts = ctx.ocrTexts;
+        // 原地过滤并外扩检测框，OCR 直接读取检测结果中的框
+        preprocess_detection_result(yolo_detection_result, data.image.cols, data.image.rows);
+        // OCR 引擎按调用分配上下文，各任务线程可并发识别
+        cv::Mat ocr_image = data.image;
+        if (m_paddleOcr->inference_from_custom_boxes(ocr_image, yolo_detection_result.boxes.data(),
+                                                     static_cast<size_t>(yolo_detection_result.num), ocrTexts).index() != 0) {
+            ocrTexts.clear();
+        }
+        if (ocrTexts.size() == 0) {
+            currentTrianNum = "";
+        }
+        else {
+            currentTrianNum = ocrTexts[0];
+        }
+    }
+
+    // 保存识别图像
+    if (m_GlobalParam.isSave) {
+        std::string save_path = m_GlobalParam.savePath + data.timestamp + "\\";
+        if (!std::filesystem::exists(save_path)) {
+            std::filesystem::create_directories(save_path);
+            emit m_Logs(QString("创建保存目录：%1成功").arg(save_path.c_str()));
+            m_logger->logInfo(fmt::format("创建保存目录：{}成功", save_path), false);
+        }
+
+        // visualize(data.image, yolo_detection_result, m_labels);
+        if(currentTrianNum.length() > 0) {
+            std::string saveFile = save_path + data.imageSequenceNumber + ".jpg";
+            cv::imwrite(saveFile, data.image);
+        }
+    }
+
+    ctx.trainNumberDetector.processFrame(currentTrianNum, extraTrainNum);
+
+    if (!extraTrainNum.empty()) {
+        m_logger->logInfo(fmt::format("识别到车号: {}", extraTrainNum), false);
+        emit m_Logs(QString("识别到车号: %1").arg(extraTrainNum.c_str()));
+        ctx.trainNumCount++;
+        ctx.trianString.append(FileTools::getInstance().str_format("#%d&%s", ctx.trainNumCount, extraTrainNum.c_str()));
+        ctx.trianNums.push_back(extraTrainNum);
+    }
+}
+
+void ThreadManager::logPerformanceReport(deploy::DetectModel& detector, const std::string& timestamp) {
+    if (!m_GlobalParam.performanceReport) {
+        return;
+    }
+    // 读取后统计清零，每次输出的是本任务内的耗时
+    deploy::PerformanceReport report = detector.getPerformanceReport();
+    if (report.requests == 0) {
+        return;
+    }
+    // percentiles 依次为 P90/P99/P99.9
+    auto stage = [](const char* name, const deploy::PerformanceResult& r) {
+        if (r.count == 0) {
+            return std::string();
+        }
+        return fmt::format(", {} 中位 {:.2f} P99 {:.2f} 最大 {:.2f}", name, r.median, r.percentiles[1], r.max);
+    };
+    m_logger->logInfo(fmt::format("检测耗时(ms): 时间戳 {}, {} 张, 吞吐 {:.1f} qps, 端到端 中位 {:.2f} P99 {:.2f}{}{}{}{}",
+        timestamp, report.requests, report.throughput, report.cpu.median, report.cpu.percentiles[1],
+        stage("预处理", report.preprocess), stage("推理", report.inference),
+        stage("输出拷贝", report.output_copy), stage("后处理", report.postprocess)), false);
+}
+
+void ThreadManager::finishTask(TaskContext& ctx) {
+    // 初始化车号结果
+    std::string trainPlants, trianDiretion, CorrectString;
+    std::string msg;
+
+    if (ctx.trainNumCount == 0) {
+        m_logger->logInfo(fmt::format("当前任务未检测到车号"), false);
+        emit m_Logs(QString("当前任务未检测到车号"));
+
+        msg = FileTools::getInstance().str_format("{CHJG}&%s&2&0&NULL&0&NULL", ctx.timestamp.c_str());
+    }
+    else {
+
+        switch (m_AlgParam.trian_type) {
+            case 0:
+                m_logger->logInfo(fmt::format("地铁纯数字车号识别结果"), false);
+                emit m_Logs(QString("地铁纯数字车号识别结果"));
+                ctx.metroTrainParser.parse(ctx.trianString);
+                trainPlants = ctx.metroTrainParser.getTrainNumber();
+                trianDiretion = ctx.metroTrainParser.getDirection();
+                CorrectString = ctx.metroTrainParser.getCorrectedInput();
+                break;
+            case 1:
+                trainPlants = "N/A";
+                trianDiretion = "N/A";
+                CorrectString = ctx.trianString;
+                break;
+            case 2:
+                m_logger->logInfo(fmt::format("高铁车号识别结果"), false);
+                emit m_Logs(QString("高铁车号识别结果"));
+                ctx.trainParser.parse(ctx.trianString);
+                trainPlants = ctx.trainParser.getTrainNumber();
+                trianDiretion = ctx.trainParser.getDirection();
+                CorrectString = ctx.trainParser.getCorrectedInput();
+                break;
+            default:
+                m_logger->logInfo(fmt::format("未配置车型，请在配置文件中配置车型"), false);
+                emit m_Logs(QString("未配置车型，请在配置文件中配置车型"));
+                trainPlants = "N/A";
+                trianDiretion = "N/A";
+                CorrectString = ctx.trianString;
+                break;
+        }
+
+        msg = FileTools::getInstance().str_format("{CHJG}&%s&2&%s&%s&%d&%s", ctx.timestamp.c_str(),
+                          trianDiretion.c_str(), trainPlants.c_str(), ctx.trainNumCount, CorrectString.c_str() );
+    }
+
+    emit m_ShowString(msg);
+    // 发送消息
+    {
+        std::lock_guard<std::mutex> lock(m_sendMutex);
+        m_udpTool->Send(msg.c_str(), msg.size(),m_udpToolParam.send_ip, m_udpToolParam.send_port);
+    }
+    m_logger->logInfo(fmt::format("当前任务识别完成，发送消息: {}", msg), false);
+    emit m_Logs(QString("当前任务识别完成，发送消息: %1").arg(msg.c_str()));
+}
+
 // 在图像上可视化推理结果
 void ThreadManager::visualize(cv::Mat& image, const deploy::DetectRes& result, const std::vector<std::string>& labels) {
 
@@ -554,52 +876,23 @@ std::string ThreadManager::getCurrentNum(const deploy::DetectRes& result,
 }
 
 
-cv::Mat ThreadManager::getStitchImageOptimized( const cv::Mat& img1, const cv::Mat& img2, const cv::Mat& img3,
-                                 double height_reduction_factor, const cv::Size& final_target_size) 
-{
-    
-    if (img1.empty() || img2.empty() || img3.empty()) {
-        return cv::Mat();
-    }
-    
-    // 计算目标尺寸
-    int target_height = static_cast<int>(img1.rows / height_reduction_factor);
-    int target_width_per_img = final_target_size.width / 3;
-    
-    // 预分配最终图像
-    cv::Mat final_image(final_target_size, img1.type());
-    
-    // 直接resize到目标区域，避免中间拷贝
-    cv::Rect roi1(0, 0, target_width_per_img, final_target_size.height);
-    cv::Rect roi2(target_width_per_img, 0, target_width_per_img, final_target_size.height);
-    cv::Rect roi3(2 * target_width_per_img, 0, target_width_per_img, final_target_size.height);
-    
-    cv::resize(img1, final_image(roi1), roi1.size(), 0, 0, cv::INTER_AREA);
-    cv::resize(img2, final_image(roi2), roi2.size(), 0, 0, cv::INTER_AREA);
-    cv::resize(img3, final_image(roi3), roi3.size(), 0, 0, cv::INTER_AREA);
-    
-    return final_image;
-}
-
-deploy::DetectRes ThreadManager::preprocess_detection_result(
-    const deploy::DetectRes& yolo_detection_result,
+// 原地过滤并外扩检测框，保留的结果前移，容量复用
+void ThreadManager::preprocess_detection_result(
+    deploy::DetectRes& yolo_detection_result,
     int image_width,
     int image_height) {
 
     // 4. 没有检测到框就直接返回
     if (yolo_detection_result.num == 0) {
-        return yolo_detection_result;
+        return;
     }
 
-    std::vector<int> filtered_classes;
-    std::vector<float> filtered_scores;
-    std::vector<deploy::Box> filtered_and_expanded_boxes;
-
     float image_w_float = static_cast<float>(image_width);
     float image_h_float = static_cast<float>(image_height);
 
+    int kept = 0;
     for (int i = 0; i < yolo_detection_result.num; ++i) {
-        const deploy::Box& current_box = yolo_detection_result.boxes[i];
+        const deploy::Box current_box = yolo_detection_result.boxes[i];
 
         // a. 去除在和边界的框
         // 假设边界框的定义是其任何一边紧贴图像边缘
@@ -635,14 +928,14 @@ deploy::DetectRes ThreadManager::preprocess_detection_result(
             continue;
         }
 
-        filtered_and_expanded_boxes.emplace_back(new_left, new_top, new_right, new_bottom);
-        filtered_classes.push_back(yolo_detection_result.classes[i]);
-        filtered_scores.push_back(yolo_detection_result.scores[i]);
+        yolo_detection_result.boxes[kept] = deploy::Box(new_left, new_top, new_right, new_bottom);
+        yolo_detection_result.classes[kept] = yolo_detection_result.classes[i];
+        yolo_detection_result.scores[kept] = yolo_detection_result.scores[i];
+        ++kept;
     }
 
-    return deploy::DetectRes(
-        static_cast<int>(filtered_and_expanded_boxes.size()),
-        filtered_classes,
-        filtered_scores,
-        filtered_and_expanded_boxes);
+    yolo_detection_result.num = kept;
+    yolo_detection_result.boxes.resize(kept);
+    yolo_detection_result.classes.resize(kept);
+    yolo_detection_result.scores.resize(kept);
 }
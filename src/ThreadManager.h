@@ -3,9 +3,14 @@
 #include <vector>
 #include <memory>
 #include <atomic> // Added for std::atomic
+#include <deque>
+#include <future>
+#include <map>
+#include <mutex>
 #include <QObject>
 #include <optional>
 #include "configread.h"
+#include "BoundedQueue.h"
 class ThreadManager : public QObject
 {
     Q_OBJECT
@@ -20,14 +25,13 @@ public:
 private:
 
     bool UdpToolRecvMessage();
-    bool UdpProcessMessage();
+    bool UdpProcessMessage(int workerId);
     bool PicProcessThread();
+    bool StreamWatchThread();
 
     void visualize(cv::Mat& image, const deploy::DetectRes& result, const std::vector<std::string>& labels);
     std::string getCurrentNum(const deploy::DetectRes& result, const std::vector<std::string>& labels, int image_width, int image_height, float margin);
-    cv::Mat getStitchImageOptimized( const cv::Mat& img1, const cv::Mat& img2, const cv::Mat& img3,
-                                                    double height_reduction_factor, const cv::Size& final_target_size) ;
-    deploy::DetectRes preprocess_detection_result(const deploy::DetectRes& yolo_detection_result,int image_width, int image_height);
+    void preprocess_detection_result(deploy::DetectRes& yolo_detection_result, int image_width, int image_height);
 public:
 
     struct StitchedImageData {
@@ -37,17 +41,47 @@ public:
         std::string timestamp;
     };
 
-    std::queue<StitchedImageData> m_queue_picProcess;
-    std::shared_ptr<std::mutex> m_mtx_picProcess;
+private:
+
+    // 单个过车任务的识别状态，每个时间戳独立一份，多个任务可并行处理
+    struct TaskContext {
+        std::string timestamp;
+        TrainNumberDetector trainNumberDetector;
+        TrainParser trainParser;
+        MetroTrainParser metroTrainParser;
+        int trainNumCount = 0;
+        std::string trianString;
+        std::vector<std::string> trianNums;
+        std::vector<std::string> ocrTexts;     // OCR 识别结果，逐帧复用
+    };
+
+    // 流式任务状态，监听线程发现新目录时创建，收到UDP消息后标记过车结束
+    struct StreamState {
+        std::string timestamp;
+        std::atomic<bool> ended{false};
+    };
+
+    // 任务队列元素：UDP消息，或流式接入发现的过车目录
+    struct TaskRequest {
+        std::string message;
+        std::shared_ptr<StreamState> stream;
+    };
+
+    void runTask(int workerId, const std::string& timestamp, const std::shared_ptr<StreamState>& stream);
+    std::unique_ptr<TaskContext> createTaskContext(const std::string& timestamp);
+    void detect(int workerId, const cv::Mat& image, deploy::DetectRes& result);
+    void processFrame(TaskContext& ctx, const StitchedImageData& data, deploy::DetectRes& yolo_detection_result);
+    void finishTask(TaskContext& ctx);
+    void logPerformanceReport(deploy::DetectModel& detector, const std::string& timestamp);
+
+public:
+
+    std::unique_ptr<BoundedQueue<StitchedImageData>> m_queue_picProcess;
 
 private:
     std::atomic<bool> threadStop;
 
-    std::queue<std::string> m_queue_udpTool;
-    std::shared_ptr<std::mutex> m_mtx_udpTool;
-
-    std::queue<std::string> m_queue_udpProcess;
-    std::shared_ptr<std::mutex> m_mtx_udpProcess;
+    std::unique_ptr<BoundedQueue<TaskRequest>> m_queue_udpTool;
 
     std::unique_ptr<UdpTool> m_udpTool;
     std::unique_ptr<ConfigRead> m_ConfigRead;
@@ -57,19 +91,22 @@ private:
     UdpToolParam m_udpToolParam;
     GlobalParam m_GlobalParam;
     AlgorithmParam m_AlgParam;
+    OCRParam m_OCRParam;
 
     PaddleOCR::ParamsOCR m_ParamsOCR;
 
     std::vector<std::shared_ptr<std::thread>> m_threads;
     std::unique_ptr<deploy::DetectModel> m_detector;
-    
-    // 算法处理相关
-    std::unique_ptr<TrainParser> m_trainParser;
-    std::unique_ptr<TrainNumberDetector> m_trainNumberDetector;
-    std::unique_ptr<MetroTrainParser> m_MetrotrainParser;
-    int trainNumCount;
-    std::string trianString;
-    std::vector<std::string> trianNums;
+    std::vector<std::unique_ptr<deploy::DetectModel>> m_workerDetectors;   // 任务线程各自的检测模型
+    std::unique_ptr<DetectBatcher> m_detectBatcher;                         // 多batch引擎的批量检测
+    int m_taskWorkers = 0;
+
+    std::mutex m_sendMutex;     // UDP 发送互斥
+
+    std::map<std::string, std::shared_ptr<StreamState>> m_streams;  // 等待结束消息的流式任务
+    std::string m_latestStream;     // 已分配处理的最新过车目录时间戳，监听线程只接入更新的目录
+    std::deque<std::string> m_finishedStreams;  // 已由流式任务处理的目录，迟到的UDP消息不再整目录处理
+    std::mutex m_streamMutex;
 
 private:
 
@@ -79,6 +116,10 @@ private:
     }; 
     std::optional<TaskRecord> lastTask; 
     static constexpr int64_t TASK_WINDOW = 10; 
+    static constexpr size_t FINISHED_STREAM_HISTORY = 64;   // m_finishedStreams 保留的目录数
+
+    // 记录已流式处理的目录，调用方需持有 m_streamMutex
+    void rememberFinishedStream(const std::string& timestamp);
 
     std::shared_ptr<LogManager> logManager = LogManager::getInstance("Logs/log.txt", spdlog::level::info);
     std::shared_ptr<Logger> m_logger = logManager->getLogger();
@@ -4,7 +4,7 @@ ConfigRead::ConfigRead() : m_ini(true, false, false) {}
 
 ConfigRead::~ConfigRead() {}
 
-bool ConfigRead::ReadConfig(std::string path, GlobalParam& globalParam, UdpToolParam& udpToolParam, AlgorithmParam& algParam) {
+bool ConfigRead::ReadConfig(std::string path, GlobalParam& globalParam, UdpToolParam& udpToolParam, AlgorithmParam& algParam, OCRParam& ocrParam) {
 
     SI_Error rc = m_ini.LoadFile(path.c_str());
     if (rc < 0) {
@@ -73,6 +73,38 @@ bool ConfigRead::ReadConfig(std::string path, GlobalParam& globalParam, UdpToolP
         return false;
     }
 
+    // 可选参数，缺省时使用默认值
+    ReadIniValue(globalSection, "StitchBandTop", globalParam.stitchBandTop);
+    ReadIniValue(globalSection, "StitchBandBottom", globalParam.stitchBandBottom);
+    ReadIniValue(globalSection, "DecodeScale", globalParam.decodeScale);
+    ReadIniValue(globalSection, "UdpQueueCapacity", globalParam.udpQueueCapacity);
+    ReadIniValue(globalSection, "PicQueueCapacity", globalParam.picQueueCapacity);
+    ReadIniValue(globalSection, "PicQueueHighWatermark", globalParam.picQueueHighWatermark);
+    ReadIniValue(globalSection, "PicQueueLowWatermark", globalParam.picQueueLowWatermark);
+    ReadIniValue(globalSection, "MaxConcurrentTasks", globalParam.maxConcurrentTasks);
+    ReadIniValue(globalSection, "BatchTimeoutMs", globalParam.batchTimeoutMs);
+    ReadIniValue(globalSection, "InferBackend", globalParam.inferBackend);
+    ReadIniValue(globalSection, "CpuThreads", globalParam.cpuThreads);
+    ReadIniValue(globalSection, "DetScoreThresh", globalParam.detScoreThresh);
+    ReadIniValue(globalSection, "DetIouThresh", globalParam.detIouThresh);
+    ReadIniValue(globalSection, "DetMaxDetections", globalParam.detMaxDetections);
+    ReadIniValue(globalSection, "PerformanceReport", globalParam.performanceReport);
+    ReadIniValue(globalSection, "StreamingMode", globalParam.streamingMode);
+    ReadIniValue(globalSection, "StreamIdleTimeoutSec", globalParam.streamIdleTimeoutSec);
+
+    // OCR 推理配置（可选）
+    const std::string ocrSection = "OCRParam";
+    ReadIniValue(ocrSection, "GlobalThreadPool", ocrParam.globalThreadPool);
+    ReadIniValue(ocrSection, "GlobalIntraThreads", ocrParam.globalIntraThreads);
+    ReadIniValue(ocrSection, "DetIntraThreads", ocrParam.detIntraThreads);
+    ReadIniValue(ocrSection, "ClsIntraThreads", ocrParam.clsIntraThreads);
+    ReadIniValue(ocrSection, "RecIntraThreads", ocrParam.recIntraThreads);
+    ReadIniValue(ocrSection, "InterThreads", ocrParam.interThreads);
+    ReadIniValue(ocrSection, "AllowSpinning", ocrParam.allowSpinning);
+    ReadIniValue(ocrSection, "TbbThreads", ocrParam.tbbThreads);
+    ReadIniValue(ocrSection, "ClsMode", ocrParam.clsMode);
+    ReadIniValue(ocrSection, "ClsThresh", ocrParam.clsThresh);
+    ReadIniValue(ocrSection, "RecCharset", ocrParam.recCharset);
 
     // 算法参数配置
     const std::string algorithmParam = "AlgorithmParam";
@@ -9,7 +9,7 @@ public:
     ConfigRead();
     ~ConfigRead();
 
-    bool ReadConfig(std::string path, GlobalParam& globalParam, UdpToolParam& udpToolParam, AlgorithmParam& algParam);
+    bool ReadConfig(std::string path, GlobalParam& globalParam, UdpToolParam& udpToolParam, AlgorithmParam& algParam, OCRParam& ocrParam);
 
 private:
     CSimpleIniA m_ini;
@@ -76,3 +76,57 @@ std::string FileTools::get_stem(const std::string &filename)
     size_t pos = filename.find_last_of('.');
     return (std::string::npos == pos) ? filename : filename.substr(0, pos);
 }
+
+bool FileTools::GetJpegSize(const std::string& filePath, cv::Size& size)
+{
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+
+    unsigned char soi[2] = { 0 };
+    if (!file.read(reinterpret_cast<char*>(soi), 2) || soi[0] != 0xFF || soi[1] != 0xD8) {
+        return false;
+    }
+
+    // 逐段跳过，直到SOF段（0xC0~0xCF，除去DHT/JPG/DAC）
+    while (file) {
+        int c = file.get();
+        if (c != 0xFF) {
+            return false;
+        }
+        int marker = file.get();
+        while (marker == 0xFF) {
+            marker = file.get();
+        }
+        if (marker == EOF || marker == 0xD9 || marker == 0xDA) {
+            return false;
+        }
+        if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD7)) {
+            continue;
+        }
+
+        unsigned char len[2] = { 0 };
+        if (!file.read(reinterpret_cast<char*>(len), 2)) {
+            return false;
+        }
+        int segment_length = (len[0] << 8) | len[1];
+        if (segment_length < 2) {
+            return false;
+        }
+
+        if (marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC) {
+            unsigned char sof[5] = { 0 };
+            if (!file.read(reinterpret_cast<char*>(sof), 5)) {
+                return false;
+            }
+            size.height = (sof[1] << 8) | sof[2];
+            size.width = (sof[3] << 8) | sof[4];
+            return size.width > 0 && size.height > 0;
+        }
+
+        file.seekg(segment_length - 2, std::ios::cur);
+    }
+
+    return false;
+}
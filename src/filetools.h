@@ -42,6 +42,9 @@ public:
 
     std::string get_stem(const std::string &filename);
 
+    // 读取JPEG文件头中的图像尺寸，不解码像素；非JPEG或文件损坏时返回false
+    bool GetJpegSize(const std::string& filePath, cv::Size& size);
+
 
     // 拼接字符串
     template <typename... Args>
@@ -24,6 +24,10 @@
 #include "yolo/option.hpp"
 #include "yolo/result.hpp"
 #include "filetools.h"
+#include "FrameCache.h"
+#include "ImageStitcher.h"
+#include "DetectBatcher.h"
+#include "DirectoryWatcher.h"
 #include "algorithm/CRHTrainTypeAlg.h"
 #include "algorithm/TrainNumberDetector.h"
 #include "algorithm/MetroTypeAlg.h"
@@ -36,9 +40,41 @@ struct GlobalParam {
     int recMode;
     int resizeWidth, reiszeHeight;     // Resize大小
     double factor;                     // 缩放因子
+    double stitchBandTop = 0.5;        // 拼接图保留区域起始位置（占拼接图高度比例）
+    double stitchBandBottom = 1.0;     // 拼接图保留区域结束位置（占拼接图高度比例）
+    int decodeScale = 0;               // JPEG解码缩放倍数 0->自动 1->原尺寸 2/4/8->强制
+    int udpQueueCapacity = 16;         // 任务消息队列容量，满时丢弃新任务
+    int picQueueCapacity = 32;         // 拼接图片队列容量（仅界面手动处理，UDP/流式任务不经过此队列）
+    int picQueueHighWatermark = 32;    // 拼接图片队列高水位，达到后阻塞拼接线程（仅界面手动处理）
+    int picQueueLowWatermark = 16;     // 拼接图片队列低水位，降到此值以下恢复拼接（仅界面手动处理）
+    int maxConcurrentTasks = 2;        // 并行处理的过车任务数
+    int batchTimeoutMs = 5;            // 批量检测凑批的最长等待时间(ms)
+    int inferBackend = 0;              // 检测推理后端 0->TensorRT 1->ONNX Runtime CPU
+    int cpuThreads = 0;                // CPU 推理后端线程数，0 由 ONNX Runtime 决定
+    float detScoreThresh = 0.25f;      // 无 NMS 插件的检测模型解码置信度阈值
+    float detIouThresh = 0.45f;        // 无 NMS 插件的检测模型 NMS IoU 阈值
+    int detMaxDetections = 300;        // 无 NMS 插件的检测模型保留的最大目标数
+    bool performanceReport = false;    // 每个过车任务结束后输出检测模型各阶段耗时
+    bool streamingMode = false;        // 流式接入：监听图片目录，过车过程中边写入边识别
+    int streamIdleTimeoutSec = 30;     // 流式任务无新图片且未收到结束消息的超时时间(秒)
     bool isSave;
 };
 
+// OCR 推理配置，[OCRParam] 段可省略
+struct OCRParam {
+    bool globalThreadPool = false;     // det/cls/rec 共享全局线程池
+    int globalIntraThreads = 0;        // 全局线程池 intra-op 线程数，0 由 ONNX Runtime 决定
+    int detIntraThreads = 2;           // 独立线程池时各会话 intra-op 线程数
+    int clsIntraThreads = 2;
+    int recIntraThreads = 2;
+    int interThreads = 1;              // inter-op 线程数
+    bool allowSpinning = true;         // 线程池空闲自旋
+    int tbbThreads = 0;                // 前后处理 TBB 线程上限，0 不限制
+    int clsMode = 0;                   // 方向分类 0->常开 1->先识别，低置信度时再分类
+    float clsThresh = 0.9f;            // 自适应分类的识别置信度阈值
+    std::string recCharset;            // 识别字符集，非空时裁剪识别模型输出头，为空使用完整字典
+};
+
 struct AlgorithmParam {
     int max_empty_frames;
     int min_length;
@@ -8,6 +8,10 @@
  *
  */
 
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+
 #include "yolo/core/buffer.hpp"
 #include "yolo/core/macro.hpp"
 
@@ -233,6 +237,54 @@ void MappedBuffer::hostToDevice(cudaStream_t stream) {}
 
 void MappedBuffer::deviceToHost(cudaStream_t stream) {}
 
+HostBuffer::HostBuffer(HostBuffer&& other) noexcept
+    : host_(other.host_), size_(other.size_) {
+    other.host_ = nullptr;
+    other.size_ = 0;
+}
+
+HostBuffer& HostBuffer::operator=(HostBuffer&& other) noexcept {
+    if (this != &other) {
+        free();
+        size_       = other.size_;
+        host_       = other.host_;
+        other.host_ = nullptr;
+        other.size_ = 0;
+    }
+    return *this;
+}
+
+void HostBuffer::allocate(size_t size) {
+    if (size > size_) {
+        free();
+        host_ = std::malloc(size);  // < 分配主机内存
+        if (!host_) throw std::bad_alloc();
+        size_ = size;
+    }
+}
+
+void HostBuffer::free() {
+    if (host_) std::free(host_);  // < 释放主机内存
+    host_ = nullptr;
+    size_ = 0;
+}
+
+void* HostBuffer::device() {
+    return host_;
+}
+
+void* HostBuffer::host() {
+    return host_;
+}
+
+size_t HostBuffer::size() const {
+    return size_;
+}
+
+void HostBuffer::hostToDevice(cudaStream_t stream) {}
+
+void HostBuffer::deviceToHost(cudaStream_t stream) {}
+
 std::unique_ptr<BaseBuffer> BufferFactory::createBuffer(BufferType type) {
     switch (type) {
         case BufferType::Device:
@@ -243,6 +295,8 @@ std::unique_ptr<BaseBuffer> BufferFactory::createBuffer(BufferType type) {
             return std::make_unique<UnifiedBuffer>();            // < 创建统一内存
         case BufferType::Mapped:
             return std::make_unique<MappedBuffer>();             // < 创建映射内存
+        case BufferType::Host:
+            return std::make_unique<HostBuffer>();               // < 创建主机内存
         default:
             throw std::invalid_argument("Unknown buffer type");  // < 未知的缓冲区类型
     }
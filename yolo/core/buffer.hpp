@@ -184,6 +184,33 @@ private:
     size_t size_;    // < 内存大小
 };
 
+/**
+ * @brief HostBuffer 类，表示仅主机内存（CPU 推理后端使用）
+ *
+ * device() 与 host() 返回同一块主机内存，拷贝操作为空操作，不调用任何 CUDA 接口。
+ */
+class HostBuffer : public BaseBuffer {
+public:
+    HostBuffer() : size_(0), host_(nullptr) {}
+    HostBuffer(const HostBuffer&)            = delete;
+    HostBuffer& operator=(const HostBuffer&) = delete;
+    HostBuffer(HostBuffer&& other) noexcept;
+    HostBuffer& operator=(HostBuffer&& other) noexcept;
+    ~HostBuffer() { free(); }
+
+    void   allocate(size_t size) override;
+    void   free() override;
+    void*  device() override;
+    void*  host() override;
+    size_t size() const override;
+    void   hostToDevice(cudaStream_t stream = nullptr) override;
+    void   deviceToHost(cudaStream_t stream = nullptr) override;
+
+private:
+    void*  host_;    // < 主机内存指针
+    size_t size_;    // < 内存大小
+};
+
 /**
  * @brief Buffer 类型枚举，用于选择不同类型的 Buffer
  *
@@ -192,7 +219,8 @@ enum class BufferType {
     Device,    // < 设备内存
     Discrete,  // < 分离内存（主机和设备都有内存）
     Unified,   // < 统一内存（设备和主机共享内存）
-    Mapped     // < 映射内存（用于NVIDIA集成设备）
+    Mapped,    // < 映射内存（用于NVIDIA集成设备）
+    Host       // < 仅主机内存（CPU 推理后端）
 };
 
 /**
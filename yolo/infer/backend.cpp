@@ -13,11 +13,23 @@
 
 #include "yolo/core/core.hpp"
 #include "yolo/infer/backend.hpp"
+#include "yolo/infer/ort_backend.hpp"
 #include "yolo/utils/utils.hpp"
 
 namespace deploy {
 
-TrtBackend::TrtBackend(const std::string& trt_engine_file, const InferOption& infer_option) : option(infer_option) {
+std::unique_ptr<BaseBackend> createBackend(const std::string& model_file, const InferOption& infer_option) {
+    switch (infer_option.backend) {
+        case InferBackend::OnnxRuntimeCPU:
+            return std::make_unique<OrtBackend>(model_file, infer_option);
+        case InferBackend::TensorRT:
+        default:
+            return std::make_unique<TrtBackend>(model_file, infer_option);
+    }
+}
+
+TrtBackend::TrtBackend(const std::string& trt_engine_file, const InferOption& infer_option) {
+    option = infer_option;             // < option 属于基类，不能在初始化列表中赋值
     cudaSetDevice(option.device_id);   // < 设置设备
     CHECK(cudaStreamCreate(&stream));  // < 创建 stream
 
@@ -44,7 +56,7 @@ TrtBackend::TrtBackend(const std::string& trt_engine_file, const InferOption& in
     if (!dynamic) captureCudaGraph();
 }
 
-std::unique_ptr<TrtBackend> TrtBackend::clone() {
+std::unique_ptr<BaseBackend> TrtBackend::clone() {
     auto clone_backend    = std::make_unique<TrtBackend>();
     clone_backend->option = option;
 
@@ -72,6 +84,9 @@ TrtBackend::~TrtBackend() {
     std::vector<TensorInfo>().swap(tensor_infos);
     std::vector<AffineTransform>().swap(affine_transforms);
     if (!dynamic) cuda_graph_.destroy();
+    for (auto& event : stage_events_) {
+        if (event) CHECK(cudaEventDestroy(event));
+    }
     CHECK(cudaStreamDestroy(stream));
 }
 
@@ -122,6 +137,31 @@ void TrtBackend::initialize() {
         affine_transforms.resize(max_shape.x, AffineTransform());
         if (!dynamic) inputs_buffer_->allocate(max_shape.x * infer_size_);
     }
+
+    if (option.enable_performance_report) createStageEvents();
+}
+
+void TrtBackend::createStageEvents() {
+    for (auto& event : stage_events_) {
+        if (!event) CHECK(cudaEventCreate(&event));
+    }
+}
+
+void TrtBackend::recordStage(int index) {
+    if (stage_events_[index]) CHECK(cudaEventRecord(stage_events_[index], stream));
+}
+
+void TrtBackend::collectStageTimes(int num_events) {
+    if (!stage_events_[0]) return;
+
+    // 相邻事件之间依次为预处理、推理、输出拷贝
+    CHECK(cudaEventSynchronize(stage_events_[num_events - 1]));
+    LatencyHistogram* stages[] = {&stage_times.preprocess, &stage_times.inference, &stage_times.output_copy};
+    for (int i = 0; i + 1 < num_events; ++i) {
+        float ms{0.0F};
+        CHECK(cudaEventElapsedTime(&ms, stage_events_[i], stage_events_[i + 1]));
+        stages[i]->record(ms);
+    }
 }
 
 void TrtBackend::captureCudaGraph() {
@@ -225,6 +265,9 @@ void TrtBackend::staticInfer(const std::vector<Image>& inputs) {
         throw std::invalid_argument("Number of inputs out of range");
     }
 
+    // 流此时空闲，事件时间即主机端开始准备输入的时间
+    recordStage(0);
+
     if (option.input_shape.has_value()) {
         if (option.cuda_mem) {
             for (int idx = 0; idx < num; ++idx) {
@@ -306,7 +349,11 @@ void TrtBackend::staticInfer(const std::vector<Image>& inputs) {
     }
 
     // Launch the CUDA graph
+    // 拷贝、仿射变换、推理与输出拷贝在同一个图中执行，整体计入推理阶段
+    recordStage(1);
     cuda_graph_.launch(stream);
+    recordStage(2);
+    collectStageTimes(3);
 }
 
 void TrtBackend::dynamicInfer(const std::vector<Image>& inputs) {
@@ -317,6 +364,9 @@ void TrtBackend::dynamicInfer(const std::vector<Image>& inputs) {
         throw std::invalid_argument("Number of inputs out of range");
     }
 
+    // 预处理阶段包含主机端输入拷贝（期间流空闲）、上传与仿射变换
+    recordStage(0);
+
     // 更新 tensor_info 的 shape 和设备地址
     for (auto& tensor_info : tensor_infos) {
         tensor_info.shape.d[0] = num;
@@ -407,9 +457,11 @@ void TrtBackend::dynamicInfer(const std::vector<Image>& inputs) {
     }
 
     // 推理
+    recordStage(1);
     if (!manager_->enqueueV3(stream)) {
         throw std::runtime_error("Infer Error.");
     }
+    recordStage(2);
 
     // 数据拷贝从设备到主机
     for (auto& tensor_info : tensor_infos) {
@@ -417,9 +469,11 @@ void TrtBackend::dynamicInfer(const std::vector<Image>& inputs) {
             tensor_info.buffer->deviceToHost(stream);
         }
     }
+    recordStage(3);
 
     // 同步流，确保所有 CUDA 操作完成
     CHECK(cudaStreamSynchronize(stream));
+    collectStageTimes(4);
 }
 
 void TrtBackend::infer(const std::vector<Image>& inputs) {
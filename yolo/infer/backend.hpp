@@ -1,7 +1,7 @@
 ﻿/**
  * @file backend.hpp
  * @author laugh12321 (laugh12321@vip.qq.com)
- * @brief TensorRT 推理后端定义
+ * @brief 推理后端接口与 TensorRT 推理后端定义
  * @date 2025-01-15
  *
  * @copyright Copyright (c) 2025 laugh12321. All Rights Reserved.
@@ -21,13 +21,57 @@
 #include "yolo/infer/warpaffine.hpp"
 #include "yolo/option.hpp"
 #include "yolo/result.hpp"
+#include "yolo/utils/utils.hpp"
 
 namespace deploy {
 
+/**
+ * @brief 推理后端抽象基类
+ *
+ * BaseModel 只通过该接口访问后端：输入经仿射变换写入 tensor_infos[0]，
+ * 推理完成后输出张量的 host() 内存可直接读取，后处理与具体后端无关。
+ */
+class DEPLOYAPI BaseBackend {
+public:
+    virtual ~BaseBackend() = default;
+
+    /**
+     * @brief 克隆后端对象，共享模型权重，独立的输入输出缓冲区。
+     *
+     * @return 克隆后的后端对象的智能指针。
+     */
+    virtual std::unique_ptr<BaseBackend> clone() = 0;
+
+    /**
+     * @brief 执行推理操作。
+     *
+     * @param inputs 输入图像向量。
+     */
+    virtual void infer(const std::vector<Image>& inputs) = 0;
+
+    cudaStream_t                 stream = nullptr;   // < CUDA 流，CPU 后端为空
+    InferOption                  option;             // < 推理选项
+    std::vector<TensorInfo>      tensor_infos;       // < 张量信息向量
+    std::vector<AffineTransform> affine_transforms;  // < 仿射变换向量
+    int4                         min_shape;          // < 最小形状
+    int4                         max_shape;          // < 最大形状
+    bool                         dynamic = false;    // < 是否为动态形状
+    StageTimes                   stage_times;        // < 各阶段耗时，启用性能报告时记录
+};
+
+/**
+ * @brief 根据推理选项创建对应的推理后端
+ *
+ * @param model_file 模型文件路径（TensorRT 为 .engine，ONNX Runtime 为 .onnx）
+ * @param infer_option 推理选项
+ * @return 推理后端的智能指针
+ */
+DEPLOYAPI std::unique_ptr<BaseBackend> createBackend(const std::string& model_file, const InferOption& infer_option);
+
 /**
  * @brief TensorRT 后端类，用于执行推理操作。
  */
-class DEPLOYAPI TrtBackend {
+class DEPLOYAPI TrtBackend : public BaseBackend {
 public:
     /**
      * @brief 构造函数，用于初始化 TrtBackend 对象。
@@ -45,29 +89,21 @@ public:
     /**
      * @brief 析构函数。
      */
-    ~TrtBackend();
+    ~TrtBackend() override;
 
     /**
      * @brief 克隆 TrtBackend 对象。
      *
      * @return 克隆后的 TrtBackend 对象的智能指针。
      */
-    std::unique_ptr<TrtBackend> clone();
+    std::unique_ptr<BaseBackend> clone() override;
 
     /**
      * @brief 执行推理操作。
      *
      * @param inputs 输入图像向量。
      */
-    void infer(const std::vector<Image>& inputs);
-
-    cudaStream_t                 stream;             // < CUDA 流
-    InferOption                  option;             // < 推理选项
-    std::vector<TensorInfo>      tensor_infos;       // < 张量信息向量
-    std::vector<AffineTransform> affine_transforms;  // < 仿射变换向量
-    int4                         min_shape;          // < 最小形状
-    int4                         max_shape;          // < 最大形状
-    bool                         dynamic;            // < 是否为动态形状
+    void infer(const std::vector<Image>& inputs) override;
 
 private:
     void getTensorInfo();
@@ -75,6 +111,9 @@ private:
     void captureCudaGraph();
     void dynamicInfer(const std::vector<Image>& inputs);
     void staticInfer(const std::vector<Image>& inputs);
+    void createStageEvents();
+    void recordStage(int index);
+    void collectStageTimes(int num_events);
 
     std::unique_ptr<TRTManager> manager_;        // < TensorRT 管理器对象的智能指针
     CudaGraph                   cuda_graph_;     // < CUDA 图
@@ -83,6 +122,9 @@ private:
 
     bool zero_copy_;                             // < 是否为零拷贝
 
+    static constexpr int kStageEvents = 4;                 // < 阶段边界事件数
+    cudaEvent_t          stage_events_[kStageEvents] = {};  // < 阶段边界事件，仅在启用性能报告时创建
+
     int input_size_;                             // < 输入大小
     int infer_size_;                             // < 推理大小
 };
@@ -0,0 +1,188 @@
+﻿/**
+ * @file decode.cpp
+ * @brief 原始 YOLO 检测头的 CPU 解码实现
+ *
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "yolo/infer/decode.hpp"
+#include "yolo/utils/utils.hpp"
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define DEPLOY_DECODE_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#define DEPLOY_TARGET_AVX2
+#else
+#define DEPLOY_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace deploy {
+
+namespace {
+
+constexpr int kAnchorBlock      = 32;     // < 每次处理的锚点数，逐类别按行读取 128 字节
+constexpr int kMaxNmsCandidates = 30000;  // < 参与 NMS 的最大候选数
+
+/**
+ * @brief 通过置信度阈值的锚点
+ */
+struct Candidate {
+    float score;
+    int   cls;
+    int   anchor;
+};
+
+/**
+ * @brief 标量实现，处理 [begin, end) 内的锚点，每块逐类别更新最大值
+ */
+void scoreScalar(const float* scores, int num_classes, int num_anchors, int begin, int end, float threshold,
+                 std::vector<Candidate>& out) {
+    float best[kAnchorBlock];
+    int   best_cls[kAnchorBlock];
+    for (int a = begin; a < end; a += kAnchorBlock) {
+        const int n = std::min(kAnchorBlock, end - a);
+        for (int k = 0; k < n; ++k) {
+            best[k]     = scores[a + k];
+            best_cls[k] = 0;
+        }
+        for (int c = 1; c < num_classes; ++c) {
+            const float* row = scores + static_cast<size_t>(c) * num_anchors + a;
+            // 无分支写法便于编译器自动向量化
+            for (int k = 0; k < n; ++k) {
+                const bool gt = row[k] > best[k];
+                best[k]       = gt ? row[k] : best[k];
+                best_cls[k]   = gt ? c : best_cls[k];
+            }
+        }
+        for (int k = 0; k < n; ++k) {
+            if (best[k] > threshold) out.push_back({best[k], best_cls[k], a + k});
+        }
+    }
+}
+
+#if defined(DEPLOY_DECODE_X86)
+/**
+ * @brief AVX2 实现，每块 32 个锚点分 4 组 8 路并行，返回已处理到的锚点位置
+ *
+ * 类别索引与标量实现一致：严格大于才更新，置信度相同时保留较小的类别。
+ */
+DEPLOY_TARGET_AVX2 int scoreAvx2(const float* scores, int num_classes, int num_anchors, float threshold,
+                                 std::vector<Candidate>& out) {
+    const __m256 thr = _mm256_set1_ps(threshold);
+    alignas(32) float best_buf[8];
+    alignas(32) int   cls_buf[8];
+
+    int a = 0;
+    for (; a + kAnchorBlock <= num_anchors; a += kAnchorBlock) {
+        __m256  best[4];
+        __m256i best_cls[4];
+        for (int k = 0; k < 4; ++k) {
+            best[k]     = _mm256_loadu_ps(scores + a + k * 8);
+            best_cls[k] = _mm256_setzero_si256();
+        }
+        for (int c = 1; c < num_classes; ++c) {
+            const float*  row = scores + static_cast<size_t>(c) * num_anchors + a;
+            const __m256i cv  = _mm256_set1_epi32(c);
+            for (int k = 0; k < 4; ++k) {
+                __m256 v    = _mm256_loadu_ps(row + k * 8);
+                __m256 gt   = _mm256_cmp_ps(v, best[k], _CMP_GT_OQ);
+                best[k]     = _mm256_blendv_ps(best[k], v, gt);
+                best_cls[k] = _mm256_blendv_epi8(best_cls[k], cv, _mm256_castps_si256(gt));
+            }
+        }
+        for (int k = 0; k < 4; ++k) {
+            int mask = _mm256_movemask_ps(_mm256_cmp_ps(best[k], thr, _CMP_GT_OQ));
+            if (mask == 0) continue;
+            _mm256_store_ps(best_buf, best[k]);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(cls_buf), best_cls[k]);
+            for (int lane = 0; lane < 8; ++lane) {
+                if (mask & (1 << lane)) out.push_back({best_buf[lane], cls_buf[lane], a + k * 8 + lane});
+            }
+        }
+    }
+    return a;
+}
+
+const bool kHasAvx2 = SupportsAvx2();
+#endif
+
+}  // namespace
+
+void decodeDetections(const float* head, int num_classes, int num_anchors, const InferOption& option, DetectRes& result) {
+    result.num = 0;
+    result.boxes.clear();
+    result.scores.clear();
+    result.classes.clear();
+    if (num_classes <= 0 || num_anchors <= 0 || option.max_detections <= 0) return;
+
+    // 1. 每个锚点取最大类别置信度，未超过阈值的直接丢弃
+    thread_local std::vector<Candidate> candidates;
+    candidates.clear();
+
+    const float* scores = head + static_cast<size_t>(4) * num_anchors;
+    int          begin  = 0;
+#if defined(DEPLOY_DECODE_X86)
+    if (kHasAvx2) begin = scoreAvx2(scores, num_classes, num_anchors, option.score_threshold, candidates);
+#endif
+    scoreScalar(scores, num_classes, num_anchors, begin, num_anchors, option.score_threshold, candidates);
+    if (candidates.empty()) return;
+
+    // 2. 按置信度降序，相同置信度按锚点顺序保证结果稳定
+    auto by_score = [](const Candidate& lhs, const Candidate& rhs) {
+        return lhs.score > rhs.score || (lhs.score == rhs.score && lhs.anchor < rhs.anchor);
+    };
+    if (candidates.size() > static_cast<size_t>(kMaxNmsCandidates)) {
+        std::nth_element(candidates.begin(), candidates.begin() + kMaxNmsCandidates, candidates.end(), by_score);
+        candidates.resize(kMaxNmsCandidates);
+    }
+    std::sort(candidates.begin(), candidates.end(), by_score);
+
+    // 3. 贪心 NMS：候选只与已保留的框比较，保留数达到上限即停止
+    const float* cx = head;
+    const float* cy = head + num_anchors;
+    const float* w  = head + static_cast<size_t>(2) * num_anchors;
+    const float* h  = head + static_cast<size_t>(3) * num_anchors;
+
+    const size_t max_keep = static_cast<size_t>(option.max_detections);
+    result.boxes.reserve(std::min(max_keep, candidates.size()));
+    thread_local std::vector<float> areas;
+    areas.clear();
+
+    for (const auto& cand : candidates) {
+        const int   i      = cand.anchor;
+        const float half_w = w[i] * 0.5f;
+        const float half_h = h[i] * 0.5f;
+        const Box   box(cx[i] - half_w, cy[i] - half_h, cx[i] + half_w, cy[i] + half_h);
+        const float area = (box.right - box.left) * (box.bottom - box.top);
+
+        bool suppressed = false;
+        for (size_t k = 0; k < result.boxes.size(); ++k) {
+            if (!option.class_agnostic_nms && result.classes[k] != cand.cls) continue;
+            const Box&  kept    = result.boxes[k];
+            const float inter_w = std::min(box.right, kept.right) - std::max(box.left, kept.left);
+            const float inter_h = std::min(box.bottom, kept.bottom) - std::max(box.top, kept.top);
+            if (inter_w <= 0.0f || inter_h <= 0.0f) continue;
+            const float inter = inter_w * inter_h;
+            // inter / union > iou_threshold，避免除法
+            if (inter > option.iou_threshold * (area + areas[k] - inter)) {
+                suppressed = true;
+                break;
+            }
+        }
+        if (suppressed) continue;
+
+        result.boxes.push_back(box);
+        result.scores.push_back(cand.score);
+        result.classes.push_back(cand.cls);
+        areas.push_back(area);
+        if (result.boxes.size() >= max_keep) break;
+    }
+    result.num = static_cast<int>(result.boxes.size());
+}
+
+}  // namespace deploy
@@ -0,0 +1,32 @@
+﻿/**
+ * @file decode.hpp
+ * @brief 原始 YOLO 检测头的 CPU 解码
+ *
+ * 用于不含 EfficientNMS 插件的 YOLOv8/v11 导出模型，输出为 [N, 4+C, A]：
+ * 前 4 个通道为框中心与宽高 (cx, cy, w, h)，其后 C 个通道为各类别置信度。
+ *
+ */
+
+#pragma once
+
+#include "yolo/option.hpp"
+#include "yolo/result.hpp"
+
+namespace deploy {
+
+/**
+ * @brief 解码单张图像的原始检测头并做 NMS，结果写入 result
+ *
+ * 按锚点分块、逐类别做 SIMD 最大值与类别索引，置信度不超过阈值的锚点整块跳过；
+ * 候选按置信度降序排序后做 NMS（默认同类别之间），保留前 max_detections 个。
+ * 框坐标为模型输入尺度，由调用方做仿射逆变换；result 原有内容被覆盖，容量复用。
+ *
+ * @param head 单张图像的检测头数据，通道优先排列，长度 (4 + num_classes) * num_anchors
+ * @param num_classes 类别数
+ * @param num_anchors 锚点数
+ * @param option 推理选项，使用 score_threshold、iou_threshold、max_detections、class_agnostic_nms
+ * @param result 解码结果
+ */
+DEPLOYAPI void decodeDetections(const float* head, int num_classes, int num_anchors, const InferOption& option, DetectRes& result);
+
+}  // namespace deploy
@@ -0,0 +1,265 @@
+﻿/**
+ * @file ort_backend.cpp
+ * @brief ONNX Runtime CPU 推理后端实现
+ *
+ */
+
+#include <onnxruntime_cxx_api.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+#include <stdexcept>
+
+#include "yolo/infer/ort_backend.hpp"
+
+namespace deploy {
+
+namespace {
+
+/**
+ * @brief 将 ONNX 张量数据类型转换为 TensorInfo 使用的数据类型，int64 输出按 int32 保存
+ */
+nvinfer1::DataType toTrtDataType(ONNXTensorElementDataType type) {
+    switch (type) {
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT:
+            return nvinfer1::DataType::kFLOAT;
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32:
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64:
+            return nvinfer1::DataType::kINT32;
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8:
+            return nvinfer1::DataType::kUINT8;
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL:
+            return nvinfer1::DataType::kBOOL;
+        default:
+            throw std::runtime_error(MAKE_ERROR_MESSAGE("OrtBackend: unsupported tensor data type"));
+    }
+}
+
+/**
+ * @brief 拷贝到 TensorInfo 后每个元素的字节数，int64 输出按 int32 保存
+ */
+size_t hostElementSize(ONNXTensorElementDataType type) {
+    switch (type) {
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT:
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32:
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64:
+            return 4;
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8:
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL:
+            return 1;
+        default:
+            throw std::runtime_error(MAKE_ERROR_MESSAGE("OrtBackend: unsupported tensor data type"));
+    }
+}
+
+/**
+ * @brief 将 ONNX 张量形状转换为 nvinfer1::Dims，动态维度替换为 fill
+ */
+nvinfer1::Dims toDims(const std::vector<int64_t>& shape, int fill) {
+    nvinfer1::Dims dims{};
+    dims.nbDims = static_cast<int>(shape.size());
+    for (int i = 0; i < dims.nbDims; ++i) {
+        dims.d[i] = shape[i] < 0 ? fill : static_cast<int>(shape[i]);
+    }
+    return dims;
+}
+
+}  // namespace
+
+std::shared_ptr<Ort::Env> acquireOrtEnv(const OrtGlobalThreadPool* global_pool, bool* has_global_pool) {
+    static std::mutex              env_mutex;
+    static std::weak_ptr<Ort::Env> shared_env;
+    static bool                    shared_global_pool = false;
+
+    std::lock_guard<std::mutex> lock(env_mutex);
+    std::shared_ptr<Ort::Env>   env = shared_env.lock();
+    if (!env) {
+        if (global_pool) {
+            Ort::ThreadingOptions thread_options;
+            thread_options.SetGlobalIntraOpNumThreads(std::max(0, global_pool->intra_threads));
+            thread_options.SetGlobalInterOpNumThreads(std::max(0, global_pool->inter_threads));
+            thread_options.SetGlobalSpinControl(global_pool->allow_spinning ? 1 : 0);
+            env = std::make_shared<Ort::Env>(thread_options, ORT_LOGGING_LEVEL_WARNING, "deploy_ort_env");
+        } else {
+            env = std::make_shared<Ort::Env>(ORT_LOGGING_LEVEL_WARNING, "deploy_ort_env");
+        }
+        shared_env         = env;
+        shared_global_pool = global_pool != nullptr;
+    }
+    if (has_global_pool) *has_global_pool = shared_global_pool;
+    return env;
+}
+
+OrtBackend::OrtBackend(const std::string& onnx_file, const InferOption& infer_option) {
+    option = infer_option;
+    if (option.cuda_mem) {
+        throw std::invalid_argument(MAKE_ERROR_MESSAGE("OrtBackend: cuda_mem is not supported by the CPU backend"));
+    }
+
+    env_ = acquireOrtEnv();
+
+    Ort::SessionOptions session_options;
+    if (option.cpu_threads > 0) session_options.SetIntraOpNumThreads(option.cpu_threads);
+    session_options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+
+    std::filesystem::path model_path(onnx_file);
+    session_ = std::make_shared<Ort::Session>(*env_, model_path.c_str(), session_options);
+
+    // 获取 TensorInfo
+    getTensorInfo();
+
+    // 初始化相关变量
+    initialize();
+}
+
+OrtBackend::~OrtBackend() {
+    std::vector<TensorInfo>().swap(tensor_infos);
+    std::vector<AffineTransform>().swap(affine_transforms);
+}
+
+std::unique_ptr<BaseBackend> OrtBackend::clone() {
+    auto clone_backend      = std::make_unique<OrtBackend>();
+    clone_backend->option   = option;
+    clone_backend->env_     = env_;
+    clone_backend->session_ = session_;
+
+    clone_backend->getTensorInfo();
+    clone_backend->initialize();
+
+    return clone_backend;
+}
+
+void OrtBackend::getTensorInfo() {
+    std::vector<TensorInfo>().swap(tensor_infos);
+    input_names_.clear();
+    output_names_.clear();
+
+    Ort::AllocatorWithDefaultOptions allocator;
+
+    if (session_->GetInputCount() != 1) {
+        throw std::runtime_error(MAKE_ERROR_MESSAGE("OrtBackend: model must have exactly one input"));
+    }
+
+    {
+        auto name  = session_->GetInputNameAllocated(0, allocator);
+        auto info  = session_->GetInputTypeInfo(0).GetTensorTypeAndShapeInfo();
+        auto shape = info.GetShape();
+        if (shape.size() != 4 || shape[1] != 3 || shape[2] <= 0 || shape[3] <= 0) {
+            throw std::runtime_error(MAKE_ERROR_MESSAGE("OrtBackend: input must be [N, 3, H, W] with fixed H and W"));
+        }
+        // 预处理按 float 写入输入张量
+        if (info.GetElementType() != ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT) {
+            throw std::runtime_error(MAKE_ERROR_MESSAGE("OrtBackend: input tensor must be float32"));
+        }
+
+        // 动态 batch 时按单张推理
+        dynamic   = shape[0] < 0;
+        int batch = dynamic ? 1 : static_cast<int>(shape[0]);
+        min_shape = make_int4(1, 3, static_cast<int>(shape[2]), static_cast<int>(shape[3]));
+        max_shape = make_int4(batch, 3, static_cast<int>(shape[2]), static_cast<int>(shape[3]));
+
+        input_names_.emplace_back(name.get());
+        tensor_infos.emplace_back(input_names_.back(), toDims(shape, batch), toTrtDataType(info.GetElementType()), true, BufferType::Host);
+    }
+
+    for (size_t i = 0; i < session_->GetOutputCount(); ++i) {
+        auto name  = session_->GetOutputNameAllocated(i, allocator);
+        auto info  = session_->GetOutputTypeInfo(i).GetTensorTypeAndShapeInfo();
+        auto shape = info.GetShape();
+        if (!shape.empty() && shape[0] < 0) shape[0] = max_shape.x;
+
+        output_names_.emplace_back(name.get());
+        tensor_infos.emplace_back(output_names_.back(), toDims(shape, 1), toTrtDataType(info.GetElementType()), false, BufferType::Host);
+    }
+}
+
+void OrtBackend::initialize() {
+    std::vector<AffineTransform>().swap(affine_transforms);
+
+    infer_size_ = max_shape.y * max_shape.w * max_shape.z;
+
+    if (option.input_shape.has_value()) {
+        affine_transforms.emplace_back(AffineTransform());
+        affine_transforms.front().updateMatrix(
+            option.input_shape->y,
+            option.input_shape->x,
+            max_shape.w,
+            max_shape.z);
+    } else {
+        affine_transforms.resize(max_shape.x, AffineTransform());
+    }
+}
+
+void OrtBackend::infer(const std::vector<Image>& inputs) {
+    auto num = static_cast<int>(inputs.size());
+
+    // 1. 判断输入是否合法，尽早返回
+    if (num < 1 || num > max_shape.x) {
+        throw std::invalid_argument("Number of inputs out of range");
+    }
+
+    // 启用性能报告时按 CPU 时间分别统计预处理、推理和输出拷贝
+    using Clock       = std::chrono::steady_clock;
+    auto stage_start  = Clock::now();
+    auto record_stage = [&](LatencyHistogram& stage) {
+        if (!option.enable_performance_report) return;
+        auto now = Clock::now();
+        stage.record(std::chrono::duration<float, std::milli>{now - stage_start}.count());
+        stage_start = now;
+    };
+
+    // 2. 仿射变换写入输入张量
+    auto& input_tensor       = tensor_infos.front();
+    input_tensor.shape.d[0]  = num;
+    input_tensor.update();
+    float* input_data = static_cast<float*>(input_tensor.buffer->host());
+
+    for (int idx = 0; idx < num; ++idx) {
+        auto& affine_transform = option.input_shape.has_value() ? affine_transforms.front() : affine_transforms[idx];
+        if (!option.input_shape.has_value()) {
+            affine_transform.updateMatrix(inputs[idx].width, inputs[idx].height, max_shape.w, max_shape.z);
+        }
+        cpuWarpAffine(inputs[idx].ptr, inputs[idx].width, inputs[idx].height,
+                      input_data + idx * infer_size_, max_shape.w, max_shape.z,
+                      affine_transform.matrix, option.config, option.cpu_threads);
+    }
+    record_stage(stage_times.preprocess);
+
+    // 3. 推理
+    auto                 memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+    std::vector<int64_t> input_shape{num, max_shape.y, max_shape.z, max_shape.w};
+    Ort::Value           input_value = Ort::Value::CreateTensor<float>(
+        memory_info, input_data, static_cast<size_t>(num) * infer_size_, input_shape.data(), input_shape.size());
+
+    std::vector<const char*> input_names{input_names_.front().c_str()};
+    std::vector<const char*> output_names;
+    for (const auto& name : output_names_) output_names.push_back(name.c_str());
+
+    auto output_values = session_->Run(Ort::RunOptions{nullptr}, input_names.data(), &input_value, 1,
+                                       output_names.data(), output_names.size());
+    record_stage(stage_times.inference);
+
+    // 4. 输出拷贝到 TensorInfo 的主机内存，形状以实际输出为准
+    for (size_t i = 0; i < output_values.size(); ++i) {
+        auto& tensor_info = tensor_infos[i + 1];
+        auto  info        = output_values[i].GetTensorTypeAndShapeInfo();
+        tensor_info.shape = toDims(info.GetShape(), 1);
+        tensor_info.update();
+
+        size_t count = info.GetElementCount();
+        if (info.GetElementType() == ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64) {
+            const int64_t* src = output_values[i].GetTensorData<int64_t>();
+            int32_t*       dst = static_cast<int32_t*>(tensor_info.buffer->host());
+            for (size_t k = 0; k < count; ++k) dst[k] = static_cast<int32_t>(src[k]);
+        } else {
+            size_t bytes = count * hostElementSize(info.GetElementType());
+            std::memcpy(tensor_info.buffer->host(), output_values[i].GetTensorMutableData<uint8_t>(), bytes);
+        }
+    }
+    record_stage(stage_times.output_copy);
+}
+
+}  // namespace deploy
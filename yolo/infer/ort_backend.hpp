@@ -0,0 +1,96 @@
+﻿/**
+ * @file ort_backend.hpp
+ * @brief ONNX Runtime CPU 推理后端定义
+ *
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "yolo/infer/backend.hpp"
+
+namespace Ort {
+struct Env;
+struct Session;
+}  // namespace Ort
+
+namespace deploy {
+
+/**
+ * @brief ONNX Runtime CPU 后端类，用于在无 GPU 的环境中执行推理。
+ *
+ * 预处理使用 cpuWarpAffine，与 TensorRT 后端的仿射变换语义一致；输出张量按 ONNX 的输出顺序
+ * 拷贝到 tensor_infos 的主机内存中，模型输出为 num_dets / boxes / scores / classes 四个张量
+ * （与 TensorRT 引擎的输出布局相同），或单个原始检测头 [N, 4+C, A]，BaseModel 的后处理无需区分后端。
+ */
+class DEPLOYAPI OrtBackend : public BaseBackend {
+public:
+    /**
+     * @brief 构造函数，用于初始化 OrtBackend 对象。
+     *
+     * @param onnx_file ONNX 模型文件路径。
+     * @param infer_option 推理选项。
+     */
+    OrtBackend(const std::string& onnx_file, const InferOption& infer_option);
+
+    /**
+     * @brief 默认构造函数。
+     */
+    OrtBackend() = default;
+
+    /**
+     * @brief 析构函数。
+     */
+    ~OrtBackend() override;
+
+    /**
+     * @brief 克隆 OrtBackend 对象，共享 ONNX Runtime 会话。
+     *
+     * @return 克隆后的 OrtBackend 对象的智能指针。
+     */
+    std::unique_ptr<BaseBackend> clone() override;
+
+    /**
+     * @brief 执行推理操作。
+     *
+     * @param inputs 输入图像向量。
+     */
+    void infer(const std::vector<Image>& inputs) override;
+
+private:
+    void getTensorInfo();
+    void initialize();
+
+    std::shared_ptr<Ort::Env>     env_;           // < ONNX Runtime 环境
+    std::shared_ptr<Ort::Session> session_;       // < ONNX Runtime 会话，克隆对象之间共享
+    std::vector<std::string>      input_names_;   // < 输入张量名称
+    std::vector<std::string>      output_names_;  // < 输出张量名称
+
+    int infer_size_;                              // < 推理大小
+};
+
+/**
+ * @brief ONNX Runtime 全局线程池配置
+ */
+struct OrtGlobalThreadPool {
+    int  intra_threads  = 0;     // < intra-op 线程数，0 由 ONNX Runtime 决定
+    int  inter_threads  = 0;     // < inter-op 线程数，0 由 ONNX Runtime 决定
+    bool allow_spinning = true;  // < 线程池空闲时是否自旋等待
+};
+
+/**
+ * @brief 获取进程内共享的 Ort::Env
+ *
+ * ONNX Runtime 每个进程只允许一个 Env，OrtBackend 与调用方的其它 ONNX Runtime 会话（如 OCR）都应通过此函数获取。
+ * 首个创建者决定 Env 的线程配置，之后的请求返回同一个 Env，全局线程池配置不再生效。
+ *
+ * @param global_pool 全局线程池配置，为空时创建不带全局线程池的 Env
+ * @param has_global_pool 非空时返回该 Env 是否带全局线程池
+ * @return 共享的 Env
+ */
+DEPLOYAPI std::shared_ptr<Ort::Env> acquireOrtEnv(const OrtGlobalThreadPool* global_pool = nullptr, bool* has_global_pool = nullptr);
+
+}  // namespace deploy
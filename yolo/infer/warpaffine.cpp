@@ -0,0 +1,367 @@
+﻿/**
+ * @file warpaffine.cpp
+ * @brief CPU 实现的仿射变换函数
+ *
+ * 逐像素复现 warpaffine.cu 中 warp_affine_bilinear 的计算（权重与累加顺序相同），保证 CPU 与 GPU 后端的预处理结果一致。
+ * letterbox 矩阵只含缩放和平移时按行列分离预计算采样坐标，内部区域使用 AVX2 一次处理 8 个像素，
+ * 并按行分块交给常驻线程池执行；一般仿射矩阵走逐像素路径。
+ *
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "yolo/infer/warpaffine.hpp"
+#include "yolo/utils/utils.hpp"
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define DEPLOY_WARP_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#define DEPLOY_TARGET_AVX2
+#else
+#define DEPLOY_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace deploy {
+
+namespace {
+
+/**
+ * @brief 单个输出像素的双线性采样，与 CUDA 核函数逐项一致
+ */
+inline void sampleBilinear(const uint8_t* src, int src_cols, int src_rows, float src_x, float src_y,
+                           float border, float sum[3]) {
+    int src_x0 = static_cast<int>(std::floor(src_x));
+    int src_y0 = static_cast<int>(std::floor(src_y));
+    int src_x1 = src_x0 + 1;
+    int src_y1 = src_y0 + 1;
+
+    float wx0 = src_x1 - src_x;
+    float wx1 = src_x - src_x0;
+    float wy0 = src_y1 - src_y;
+    float wy1 = src_y - src_y0;
+
+    bool x0_in = src_x0 >= 0 && src_x0 < src_cols;
+    bool x1_in = src_x1 >= 0 && src_x1 < src_cols;
+    bool y0_in = src_y0 >= 0 && src_y0 < src_rows;
+    bool y1_in = src_y1 >= 0 && src_y1 < src_rows;
+
+    const uint8_t* row0 = src + static_cast<ptrdiff_t>(src_y0) * src_cols * 3;
+    const uint8_t* row1 = src + static_cast<ptrdiff_t>(src_y1) * src_cols * 3;
+
+    for (int c = 0; c < 3; ++c) {
+        float v00 = (x0_in && y0_in) ? row0[src_x0 * 3 + c] : border;
+        float v01 = (x1_in && y0_in) ? row0[src_x1 * 3 + c] : border;
+        float v10 = (x0_in && y1_in) ? row1[src_x0 * 3 + c] : border;
+        float v11 = (x1_in && y1_in) ? row1[src_x1 * 3 + c] : border;
+        sum[c]    = wx0 * wy0 * v00 + wx1 * wy0 * v01 + (wx0 * wy1 * v10 + wx1 * wy1 * v11);
+    }
+}
+
+/**
+ * @brief 输出平面与归一化参数，swap_rb 通过交换平面指针实现
+ */
+struct WarpOutput {
+    float* plane[3];
+    float  alpha[3];
+    float  beta[3];
+
+    WarpOutput(float* dst, int area, const ProcessConfig& config) {
+        const int first = config.swap_rb ? 2 : 0;
+        const int last  = config.swap_rb ? 0 : 2;
+        plane[first]    = dst;
+        plane[1]        = dst + area;
+        plane[last]     = dst + 2 * area;
+        alpha[first]    = config.alpha.x;
+        alpha[1]        = config.alpha.y;
+        alpha[last]     = config.alpha.z;
+        beta[first]     = config.beta.x;
+        beta[1]         = config.beta.y;
+        beta[last]      = config.beta.z;
+    }
+
+    void store(size_t offset, const float sum[3]) const {
+        for (int c = 0; c < 3; ++c) plane[c][offset] = sum[c] * alpha[c] + beta[c];
+    }
+};
+
+/**
+ * @brief 缩放+平移矩阵下按列预计算的采样参数
+ */
+struct ColumnTable {
+    std::vector<int>   x0;
+    std::vector<float> wx0, wx1;
+    std::vector<char>  x0_in, x1_in;
+    int                simd_begin = 0;  // < [simd_begin, simd_end) 内 x0、x1 都在图像内且 x1 后还有一个像素，可整块读取
+    int                simd_end   = 0;
+};
+
+ColumnTable buildColumns(int dst_cols, int src_cols, float3 m0) {
+    ColumnTable t;
+    t.x0.resize(dst_cols);
+    t.wx0.resize(dst_cols);
+    t.wx1.resize(dst_cols);
+    t.x0_in.resize(dst_cols);
+    t.x1_in.resize(dst_cols);
+    t.simd_begin = dst_cols;
+    for (int x = 0; x < dst_cols; ++x) {
+        float src_x = m0.x * x + m0.z;
+        int   x0    = static_cast<int>(std::floor(src_x));
+        t.x0[x]     = x0;
+        t.wx0[x]    = (x0 + 1) - src_x;
+        t.wx1[x]    = src_x - x0;
+        t.x0_in[x]  = x0 >= 0 && x0 < src_cols;
+        t.x1_in[x]  = x0 + 1 >= 0 && x0 + 1 < src_cols;
+        if (x0 >= 0 && x0 + 2 < src_cols) {
+            t.simd_begin = std::min(t.simd_begin, x);
+            t.simd_end   = x + 1;
+        }
+    }
+    if (t.simd_end <= t.simd_begin) t.simd_begin = t.simd_end = 0;
+    return t;
+}
+
+/**
+ * @brief 分离路径的标量实现，处理一行中 [x_begin, x_end) 的像素
+ */
+void separableRowScalar(const uint8_t* src, int src_cols, int src_rows, const ColumnTable& cols,
+                        int y0, float wy0, float wy1, float border, const WarpOutput& out,
+                        size_t row_offset, int x_begin, int x_end) {
+    const bool     y0_in = y0 >= 0 && y0 < src_rows;
+    const bool     y1_in = y0 + 1 >= 0 && y0 + 1 < src_rows;
+    const uint8_t* row0  = src + static_cast<ptrdiff_t>(y0) * src_cols * 3;
+    const uint8_t* row1  = src + static_cast<ptrdiff_t>(y0 + 1) * src_cols * 3;
+    for (int x = x_begin; x < x_end; ++x) {
+        const int   x0  = cols.x0[x];
+        const float wx0 = cols.wx0[x];
+        const float wx1 = cols.wx1[x];
+        float       sum[3];
+        for (int c = 0; c < 3; ++c) {
+            float v00 = (cols.x0_in[x] && y0_in) ? row0[x0 * 3 + c] : border;
+            float v01 = (cols.x1_in[x] && y0_in) ? row0[(x0 + 1) * 3 + c] : border;
+            float v10 = (cols.x0_in[x] && y1_in) ? row1[x0 * 3 + c] : border;
+            float v11 = (cols.x1_in[x] && y1_in) ? row1[(x0 + 1) * 3 + c] : border;
+            sum[c]    = wx0 * wy0 * v00 + wx1 * wy0 * v01 + (wx0 * wy1 * v10 + wx1 * wy1 * v11);
+        }
+        out.store(row_offset + x, sum);
+    }
+}
+
+#if defined(DEPLOY_WARP_X86)
+/**
+ * @brief 分离路径的 AVX2 实现，两行源像素都在图像内时处理 [x_begin, x_end)，每次 8 个像素
+ *
+ * 每个邻点按 4 字节 gather 取出 BGR 三个通道，乘法与加法分开执行，不做 FMA 融合，与标量结果一致。
+ */
+DEPLOY_TARGET_AVX2 int separableRowAvx2(const uint8_t* src, int src_cols, const ColumnTable& cols,
+                                        int y0, float wy0_s, float wy1_s, const WarpOutput& out,
+                                        size_t row_offset, int x_begin, int x_end) {
+    const uint8_t* row0 = src + static_cast<ptrdiff_t>(y0) * src_cols * 3;
+    const uint8_t* row1 = row0 + static_cast<ptrdiff_t>(src_cols) * 3;
+    const __m256   wy0  = _mm256_set1_ps(wy0_s);
+    const __m256   wy1  = _mm256_set1_ps(wy1_s);
+    const __m256i  mask = _mm256_set1_epi32(0xFF);
+    const __m256i  three = _mm256_set1_epi32(3);
+
+    int x = x_begin;
+    for (; x + 8 <= x_end; x += 8) {
+        __m256i off0 = _mm256_mullo_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(cols.x0.data() + x)), three);
+        __m256i off1 = _mm256_add_epi32(off0, three);
+        __m256i p00  = _mm256_i32gather_epi32(reinterpret_cast<const int*>(row0), off0, 1);
+        __m256i p01  = _mm256_i32gather_epi32(reinterpret_cast<const int*>(row0), off1, 1);
+        __m256i p10  = _mm256_i32gather_epi32(reinterpret_cast<const int*>(row1), off0, 1);
+        __m256i p11  = _mm256_i32gather_epi32(reinterpret_cast<const int*>(row1), off1, 1);
+
+        __m256 wx0 = _mm256_loadu_ps(cols.wx0.data() + x);
+        __m256 wx1 = _mm256_loadu_ps(cols.wx1.data() + x);
+        __m256 w00 = _mm256_mul_ps(wx0, wy0);
+        __m256 w01 = _mm256_mul_ps(wx1, wy0);
+        __m256 w10 = _mm256_mul_ps(wx0, wy1);
+        __m256 w11 = _mm256_mul_ps(wx1, wy1);
+
+        for (int c = 0; c < 3; ++c) {
+            const int shift = c * 8;
+            __m256 v00 = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(p00, shift), mask));
+            __m256 v01 = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(p01, shift), mask));
+            __m256 v10 = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(p10, shift), mask));
+            __m256 v11 = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(p11, shift), mask));
+            __m256 top    = _mm256_add_ps(_mm256_mul_ps(w00, v00), _mm256_mul_ps(w01, v01));
+            __m256 bottom = _mm256_add_ps(_mm256_mul_ps(w10, v10), _mm256_mul_ps(w11, v11));
+            __m256 sum    = _mm256_add_ps(top, bottom);
+            __m256 result = _mm256_add_ps(_mm256_mul_ps(sum, _mm256_set1_ps(out.alpha[c])), _mm256_set1_ps(out.beta[c]));
+            _mm256_storeu_ps(out.plane[c] + row_offset + x, result);
+        }
+    }
+    return x;
+}
+
+const bool kHasAvx2 = SupportsAvx2();
+#endif
+
+/**
+ * @brief 进程内常驻的行分块线程池，所有 CPU 后端实例共用
+ *
+ * 任务按块编号领取，调用线程也参与执行，多个调用方并发提交时不会互相等待空闲线程。
+ */
+class RowThreadPool {
+public:
+    static RowThreadPool& instance() {
+        // 不析构：DLL 卸载时在静态析构中 join 线程可能死锁，进程退出时由系统回收
+        static RowThreadPool* pool = new RowThreadPool();
+        return *pool;
+    }
+
+    int threads() const { return static_cast<int>(workers_.size()) + 1; }
+
+    /**
+     * @brief 执行 num_chunks 个块，chunk(i) 处理第 i 块，返回时全部完成
+     */
+    void run(int num_chunks, const std::function<void(int)>& chunk) {
+        auto job        = std::make_shared<Job>();
+        job->chunk      = &chunk;
+        job->num_chunks = num_chunks;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (int i = 1; i < num_chunks; ++i) queue_.push_back(job);
+        }
+        cv_.notify_all();
+
+        drain(*job);
+        std::unique_lock<std::mutex> lock(job->mutex);
+        job->finished.wait(lock, [&] { return job->done.load() == num_chunks; });
+    }
+
+private:
+    struct Job {
+        const std::function<void(int)>* chunk = nullptr;
+        int                             num_chunks = 0;
+        std::atomic<int>                next{0};
+        std::atomic<int>                done{0};
+        std::mutex                      mutex;
+        std::condition_variable         finished;
+    };
+
+    RowThreadPool() {
+        const int count = std::max(0, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+        for (int i = 0; i < count; ++i) {
+            workers_.emplace_back([this] { workerLoop(); });
+        }
+    }
+
+    // 领取并执行剩余的块，最后一块完成时唤醒调用方
+    static void drain(Job& job) {
+        for (int i = job.next.fetch_add(1); i < job.num_chunks; i = job.next.fetch_add(1)) {
+            (*job.chunk)(i);
+            if (job.done.fetch_add(1) + 1 == job.num_chunks) {
+                std::lock_guard<std::mutex> lock(job.mutex);
+                job.finished.notify_all();
+            }
+        }
+    }
+
+    void workerLoop() {
+        for (;;) {
+            std::shared_ptr<Job> job;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this] { return !queue_.empty(); });
+                job = std::move(queue_.front());
+                queue_.pop_front();
+            }
+            drain(*job);
+        }
+    }
+
+    std::vector<std::thread>         workers_;
+    std::mutex                       mutex_;
+    std::condition_variable          cv_;
+    std::deque<std::shared_ptr<Job>> queue_;
+};
+
+/**
+ * @brief 按行分块并行执行，fn(row_begin, row_end)；分块交给常驻线程池，调用线程参与执行
+ */
+template <typename Fn>
+void parallelRows(int rows, int num_threads, Fn&& fn) {
+    constexpr int kMinRowsPerThread = 32;
+    int threads = num_threads > 0 ? num_threads : static_cast<int>(std::thread::hardware_concurrency());
+    threads     = std::max(1, std::min(threads, rows / kMinRowsPerThread));
+    if (threads == 1) {
+        fn(0, rows);
+        return;
+    }
+
+    RowThreadPool& pool = RowThreadPool::instance();
+    threads             = std::min(threads, pool.threads());
+    if (threads == 1) {
+        fn(0, rows);
+        return;
+    }
+
+    const int chunk = (rows + threads - 1) / threads;
+    pool.run((rows + chunk - 1) / chunk, [&fn, rows, chunk](int i) {
+        fn(i * chunk, std::min(rows, (i + 1) * chunk));
+    });
+}
+
+}  // namespace
+
+void cpuWarpAffine(const void* src, const int src_cols, const int src_rows,
+                   void* dst, const int dst_cols, const int dst_rows,
+                   const float3 matrix[2], const ProcessConfig& config, int num_threads) {
+    const uint8_t*   src_data = static_cast<const uint8_t*>(src);
+    const int        area     = dst_cols * dst_rows;
+    const float      border   = config.border_value;
+    const float3     m0       = matrix[0];
+    const float3     m1       = matrix[1];
+    const WarpOutput out(static_cast<float*>(dst), area, config);
+
+    // 一般仿射矩阵：逐像素计算源坐标
+    if (m0.y != 0.0f || m1.x != 0.0f) {
+        parallelRows(dst_rows, num_threads, [&](int row_begin, int row_end) {
+            for (int y = row_begin; y < row_end; ++y) {
+                for (int x = 0; x < dst_cols; ++x) {
+                    float sum[3];
+                    sampleBilinear(src_data, src_cols, src_rows, m0.x * x + m0.y * y + m0.z,
+                                   m1.x * x + m1.y * y + m1.z, border, sum);
+                    out.store(static_cast<size_t>(y) * dst_cols + x, sum);
+                }
+            }
+        });
+        return;
+    }
+
+    // 缩放+平移（letterbox）：源 x 只与列有关、源 y 只与行有关，列参数预先计算一次
+    const ColumnTable cols = buildColumns(dst_cols, src_cols, m0);
+    parallelRows(dst_rows, num_threads, [&](int row_begin, int row_end) {
+        for (int y = row_begin; y < row_end; ++y) {
+            const float  src_y      = m1.y * y + m1.z;
+            const int    y0         = static_cast<int>(std::floor(src_y));
+            const float  wy0        = (y0 + 1) - src_y;
+            const float  wy1        = src_y - y0;
+            const size_t row_offset = static_cast<size_t>(y) * dst_cols;
+
+            int x = 0;
+#if defined(DEPLOY_WARP_X86)
+            if (kHasAvx2 && y0 >= 0 && y0 + 1 < src_rows && cols.simd_end > cols.simd_begin) {
+                separableRowScalar(src_data, src_cols, src_rows, cols, y0, wy0, wy1, border, out, row_offset, 0, cols.simd_begin);
+                x = separableRowAvx2(src_data, src_cols, cols, y0, wy0, wy1, out, row_offset, cols.simd_begin, cols.simd_end);
+            }
+#endif
+            separableRowScalar(src_data, src_cols, src_rows, cols, y0, wy0, wy1, border, out, row_offset, x, dst_cols);
+        }
+    });
+}
+
+}  // namespace deploy
@@ -86,4 +86,24 @@ void cudaMutliWarpAffine(const void* src, const int src_cols, const int src_rows
                          void* dst, const int dst_cols, const int dst_rows,
                          const float3 matrix[2], const ProcessConfig config, int num_images, cudaStream_t stream);
 
+/**
+ * @brief 在 CPU 上应用仿射变换，与 `cudaWarpAffine` 的插值、边界填充、通道交换和归一化语义一致。
+ *
+ * 输入为 HWC 排列的 BGR uint8 图像，输出为 CHW 排列的 float 张量，供 CPU 推理后端使用。
+ * 插值、通道交换与归一化在一遍内完成；letterbox 矩阵使用行列分离 + AVX2 路径，按行分块多线程执行。
+ *
+ * @param src 输入图像数据的指针
+ * @param src_cols 输入图像的宽度
+ * @param src_rows 输入图像的高度
+ * @param dst 输出张量数据的指针
+ * @param dst_cols 输出图像的宽度
+ * @param dst_rows 输出图像的高度
+ * @param matrix 仿射变换矩阵（目标坐标到源坐标）
+ * @param config 处理配置参数
+ * @param num_threads 并行线程数，0 表示使用硬件线程数（每线程至少 32 行）；线程来自进程内常驻池，不随调用创建
+ */
+DEPLOYAPI void cpuWarpAffine(const void* src, const int src_cols, const int src_rows,
+                             void* dst, const int dst_cols, const int dst_rows,
+                             const float3 matrix[2], const ProcessConfig& config, int num_threads = 0);
+
 }  // namespace deploy
\ No newline at end of file
@@ -11,8 +11,10 @@
 #include <cstdint>
 #include <cstring>
 #include <sstream>
+#include <stdexcept>
 #include <vector>
 
+#include "yolo/infer/decode.hpp"
 #include "yolo/model.hpp"
 #include "yolo/result.hpp"
 
@@ -21,39 +23,76 @@ namespace deploy {
 template <typename ResultType>
 std::unique_ptr<BaseModel<ResultType>> BaseModel<ResultType>::clone() const {
     auto clone_model              = std::make_unique<BaseModel<ResultType>>();
-    clone_model->backend_         = backend_->clone();  // < 克隆 TrtBackend
-    clone_model->infer_gpu_trace_ = std::make_unique<GpuTimer>(clone_model->backend_->stream);
+    clone_model->backend_         = backend_->clone();  // < 克隆推理后端
+    if (clone_model->backend_->stream) clone_model->infer_gpu_trace_ = std::make_unique<GpuTimer>(clone_model->backend_->stream);
     clone_model->infer_cpu_trace_ = std::make_unique<CpuTimer>();
+    clone_model->postprocess_trace_ = std::make_unique<CpuTimer>();
     return clone_model;
 }
 
 template <typename ResultType>
-std::vector<ResultType> BaseModel<ResultType>::predict(const std::vector<Image>& images) {
-    if (backend_->option.enable_performance_report) {
-        total_request_ += (backend_->dynamic ? images.size() : backend_->max_shape.x);
-        infer_cpu_trace_->start();
-        infer_gpu_trace_->start();
-    }
+void BaseModel<ResultType>::predict(const std::vector<Image>& images, std::vector<ResultType>& results) {
+    startTrace(images.size());
 
     backend_->infer(images);  // 调用推理方法
+    startPostprocessTrace();
 
-    // 预分配结果空间
-    std::vector<ResultType> results(images.size());
+    // 已有元素保留各自容量，逐个覆盖
+    results.resize(images.size());
     for (auto idx = 0u; idx < images.size(); ++idx) {
-        results[idx] = postProcess(idx);
+        postProcess(idx, results[idx]);
     }
 
-    if (backend_->option.enable_performance_report) {
-        infer_gpu_trace_->stop();
-        infer_cpu_trace_->stop();
-    }
+    stopTrace();
+}
 
+template <typename ResultType>
+std::vector<ResultType> BaseModel<ResultType>::predict(const std::vector<Image>& images) {
+    std::vector<ResultType> results;
+    predict(images, results);
     return results;
 }
 
+template <typename ResultType>
+void BaseModel<ResultType>::predict(const Image& image, ResultType& result) {
+    startTrace(1);
+
+    single_input_.assign(1, image);
+    backend_->infer(single_input_);
+    startPostprocessTrace();
+    postProcess(0, result);
+
+    stopTrace();
+}
+
 template <typename ResultType>
 ResultType BaseModel<ResultType>::predict(const Image& image) {
-    return predict(std::vector<Image>{image}).front();
+    ResultType result;
+    predict(image, result);
+    return result;
+}
+
+template <typename ResultType>
+void BaseModel<ResultType>::startTrace(size_t num_images) {
+    if (backend_->option.enable_performance_report) {
+        total_request_ += (backend_->dynamic ? num_images : backend_->max_shape.x);
+        infer_cpu_trace_->start();
+        if (infer_gpu_trace_) infer_gpu_trace_->start();
+    }
+}
+
+template <typename ResultType>
+void BaseModel<ResultType>::startPostprocessTrace() {
+    if (backend_->option.enable_performance_report) postprocess_trace_->start();
+}
+
+template <typename ResultType>
+void BaseModel<ResultType>::stopTrace() {
+    if (backend_->option.enable_performance_report) {
+        postprocess_trace_->stop();
+        if (infer_gpu_trace_) infer_gpu_trace_->stop();
+        infer_cpu_trace_->stop();
+    }
 }
 
 template <typename ResultType>
@@ -61,36 +100,57 @@ int BaseModel<ResultType>::batch_size() const {
     return backend_->max_shape.x;
 }
 
+template <typename ResultType>
+PerformanceReport BaseModel<ResultType>::getPerformanceReport() {
+    PerformanceReport report;
+    if (!backend_->option.enable_performance_report) return report;
+
+    report.percentiles = {90, 99, 99.9F};
+    report.requests    = total_request_;
+
+    float total_ms    = infer_cpu_trace_->totalMilliseconds();
+    report.throughput = total_ms > 0 ? total_request_ / total_ms * 1000 : 0.f;
+    report.cpu        = getPerformanceResult(infer_cpu_trace_->histogram(), report.percentiles);
+    if (infer_gpu_trace_) report.gpu = getPerformanceResult(infer_gpu_trace_->histogram(), report.percentiles);
+
+    // 各阶段：预处理、推理、输出拷贝由后端记录，后处理在此记录
+    report.preprocess  = getPerformanceResult(backend_->stage_times.preprocess, report.percentiles);
+    report.inference   = getPerformanceResult(backend_->stage_times.inference, report.percentiles);
+    report.output_copy = getPerformanceResult(backend_->stage_times.output_copy, report.percentiles);
+    report.postprocess = getPerformanceResult(postprocess_trace_->histogram(), report.percentiles);
+
+    total_request_ = 0;
+    infer_cpu_trace_->reset();
+    if (infer_gpu_trace_) infer_gpu_trace_->reset();
+    postprocess_trace_->reset();
+    backend_->stage_times.reset();
+
+    return report;
+}
+
 template <typename ResultType>
 std::tuple<std::string, std::string, std::string> BaseModel<ResultType>::performanceReport() {
     if (backend_->option.enable_performance_report) {
-        float const       throughput = total_request_ / infer_cpu_trace_->totalMilliseconds() * 1000;
+        PerformanceReport report = getPerformanceReport();
         std::stringstream ss;
 
         // 构建吞吐量字符串
-        ss << "Throughput: " << throughput << " qps";
+        ss << "Throughput: " << report.throughput << " qps";
         std::string throughputStr = ss.str();
         ss.str("");  // 清空 stringstream
 
-        auto percentiles = std::vector<float>{90, 95, 99};
-
-        auto getLatencyStr = [&](const auto& trace, const std::string& device) {
-            auto result = getPerformanceResult(trace->milliseconds(), {0.90, 0.95, 0.99});
+        auto getLatencyStr = [&](const PerformanceResult& result, const std::string& device) {
             ss << device << " Latency: min = " << result.min << " ms, max = " << result.max << " ms, mean = " << result.mean << " ms, median = " << result.median << " ms";
-            for (int32_t i = 0, n = percentiles.size(); i < n; ++i) {
-                ss << ", percentile(" << percentiles[i] << "%) = " << result.percentiles[i] << " ms";
+            for (int32_t i = 0, n = report.percentiles.size(); i < n; ++i) {
+                ss << ", percentile(" << report.percentiles[i] << "%) = " << result.percentiles[i] << " ms";
             }
             std::string output = ss.str();
             ss.str("");  // 清空 stringstream
             return output;
         };
 
-        std::string cpuLatencyStr = getLatencyStr(infer_cpu_trace_, "CPU");
-        std::string gpuLatencyStr = getLatencyStr(infer_gpu_trace_, "GPU");
-
-        total_request_ = 0;
-        infer_cpu_trace_->reset();
-        infer_gpu_trace_->reset();
+        std::string cpuLatencyStr = getLatencyStr(report.cpu, "CPU");
+        std::string gpuLatencyStr = report.gpu ? getLatencyStr(*report.gpu, "GPU") : "";
 
         return std::make_tuple(throughputStr, cpuLatencyStr, gpuLatencyStr);
     } else {
@@ -101,11 +161,12 @@ std::tuple<std::string, std::string, std::string> BaseModel<ResultType>::perform
 
 // ClassifyModel 的后处理方法实现
 template <>
-ClassifyRes BaseModel<ClassifyRes>::postProcess(int idx) {
+void BaseModel<ClassifyRes>::postProcess(int idx, ClassifyRes& result) {
     auto&  tensor_info = backend_->tensor_infos[1];
     float* topk        = static_cast<float*>(tensor_info.buffer->host()) + idx * tensor_info.shape.d[1] * tensor_info.shape.d[2];
 
-    ClassifyRes result;
+    result.scores.clear();
+    result.classes.clear();
     result.num = tensor_info.shape.d[1];
     result.scores.reserve(result.num);
     result.classes.reserve(result.num);
@@ -114,13 +175,33 @@ ClassifyRes BaseModel<ClassifyRes>::postProcess(int idx) {
         result.scores.push_back(topk[i * tensor_info.shape.d[2]]);
         result.classes.push_back(topk[i * tensor_info.shape.d[2] + 1]);
     }
-
-    return result;
 }
 
 // DetectModel 的后处理方法实现
 template <>
-DetectRes BaseModel<DetectRes>::postProcess(int idx) {
+void BaseModel<DetectRes>::postProcess(int idx, DetectRes& result) {
+    auto& affine_transform = backend_->option.input_shape.has_value()
+                                 ? backend_->affine_transforms.front()
+                                 : backend_->affine_transforms[idx];
+
+    // 只有一个输出时为原始检测头 [N, 4+C, A]（无 EfficientNMS 插件），在 CPU 上解码
+    if (backend_->tensor_infos.size() == 2) {
+        auto& head_tensor = backend_->tensor_infos[1];
+        if (head_tensor.shape.nbDims != 3 || head_tensor.shape.d[1] <= 4) {
+            throw std::runtime_error(MAKE_ERROR_MESSAGE("DetectModel: raw detection head must be [N, 4+C, A]"));
+        }
+        int    channels = head_tensor.shape.d[1];
+        int    anchors  = head_tensor.shape.d[2];
+        float* head     = static_cast<float*>(head_tensor.buffer->host()) + static_cast<size_t>(idx) * channels * anchors;
+
+        decodeDetections(head, channels - 4, anchors, backend_->option, result);
+        for (auto& box : result.boxes) {
+            affine_transform.applyTransform(box.left, box.top, &box.left, &box.top);
+            affine_transform.applyTransform(box.right, box.bottom, &box.right, &box.bottom);
+        }
+        return;
+    }
+
     auto& num_tensor   = backend_->tensor_infos[1];
     auto& box_tensor   = backend_->tensor_infos[2];
     auto& score_tensor = backend_->tensor_infos[3];
@@ -131,14 +212,12 @@ DetectRes BaseModel<DetectRes>::postProcess(int idx) {
     float* scores  = static_cast<float*>(score_tensor.buffer->host()) + idx * score_tensor.shape.d[1];
     int*   classes = static_cast<int*>(class_tensor.buffer->host()) + idx * class_tensor.shape.d[1];
 
-    DetectRes result;
+    result.boxes.clear();
+    result.scores.clear();
+    result.classes.clear();
     result.num   = num;
     int box_size = box_tensor.shape.d[2];
 
-    auto& affine_transform = backend_->option.input_shape.has_value()
-                                 ? backend_->affine_transforms.front()
-                                 : backend_->affine_transforms[idx];
-
     result.boxes.reserve(num);
     result.scores.reserve(num);
     result.classes.reserve(num);
@@ -155,13 +234,11 @@ DetectRes BaseModel<DetectRes>::postProcess(int idx) {
         result.scores.push_back(scores[i]);
         result.classes.push_back(classes[i]);
     }
-
-    return result;
 }
 
 // OBBModel 的后处理方法实现
 template <>
-OBBRes BaseModel<OBBRes>::postProcess(int idx) {
+void BaseModel<OBBRes>::postProcess(int idx, OBBRes& result) {
     auto& num_tensor   = backend_->tensor_infos[1];
     auto& box_tensor   = backend_->tensor_infos[2];
     auto& score_tensor = backend_->tensor_infos[3];
@@ -172,7 +249,9 @@ OBBRes BaseModel<OBBRes>::postProcess(int idx) {
     float* scores  = static_cast<float*>(score_tensor.buffer->host()) + idx * score_tensor.shape.d[1];
     int*   classes = static_cast<int*>(class_tensor.buffer->host()) + idx * class_tensor.shape.d[1];
 
-    OBBRes result;
+    result.boxes.clear();
+    result.scores.clear();
+    result.classes.clear();
     result.num   = num;
     int box_size = box_tensor.shape.d[2];
 
@@ -197,13 +276,11 @@ OBBRes BaseModel<OBBRes>::postProcess(int idx) {
         result.scores.push_back(scores[i]);
         result.classes.push_back(classes[i]);
     }
-
-    return result;
 }
 
 // SegmentModel 的后处理方法实现
 template <>
-SegmentRes BaseModel<SegmentRes>::postProcess(int idx) {
+void BaseModel<SegmentRes>::postProcess(int idx, SegmentRes& result) {
     auto& num_tensor   = backend_->tensor_infos[1];
     auto& box_tensor   = backend_->tensor_infos[2];
     auto& score_tensor = backend_->tensor_infos[3];
@@ -218,7 +295,10 @@ SegmentRes BaseModel<SegmentRes>::postProcess(int idx) {
     int*     classes = static_cast<int*>(class_tensor.buffer->host()) + idx * class_tensor.shape.d[1];
     uint8_t* masks   = static_cast<uint8_t*>(mask_tensor.buffer->host()) + idx * mask_tensor.shape.d[1] * mask_height * mask_width;
 
-    SegmentRes result;
+    result.boxes.clear();
+    result.scores.clear();
+    result.classes.clear();
+    result.masks.clear();
     result.num   = num;
     int box_size = box_tensor.shape.d[2];
 
@@ -255,13 +335,11 @@ SegmentRes BaseModel<SegmentRes>::postProcess(int idx) {
 
         result.masks.emplace_back(std::move(mask));
     }
-
-    return result;
 }
 
 // PoseModel 的后处理方法实现
 template <>
-PoseRes BaseModel<PoseRes>::postProcess(int idx) {
+void BaseModel<PoseRes>::postProcess(int idx, PoseRes& result) {
     auto& num_tensor   = backend_->tensor_infos[1];
     auto& box_tensor   = backend_->tensor_infos[2];
     auto& score_tensor = backend_->tensor_infos[3];
@@ -276,7 +354,10 @@ PoseRes BaseModel<PoseRes>::postProcess(int idx) {
     int*   classes = static_cast<int*>(class_tensor.buffer->host()) + idx * class_tensor.shape.d[1];
     float* kpts    = static_cast<float*>(kpt_tensor.buffer->host()) + idx * kpt_tensor.shape.d[1] * nkpt * ndim;
 
-    PoseRes result;
+    result.boxes.clear();
+    result.scores.clear();
+    result.classes.clear();
+    result.kpts.clear();
     result.num   = num;
     int box_size = box_tensor.shape.d[2];
 
@@ -310,8 +391,6 @@ PoseRes BaseModel<PoseRes>::postProcess(int idx) {
         }
         result.kpts.emplace_back(std::move(keypoints));
     }
-
-    return result;
 }
 
 }  // namespace deploy
@@ -39,14 +39,16 @@ public:
     /**
      * @brief 构造一个新的 BaseModel 对象
      *
-     * @param trt_engine_file TensorRT 引擎文件路径
-     * @param infer_option 推理选项
+     * @param model_file 模型文件路径（TensorRT 后端为 .engine，ONNX Runtime CPU 后端为 .onnx）
+     * @param infer_option 推理选项，infer_option.backend 决定使用的推理后端
      */
-    explicit BaseModel(const std::string& trt_engine_file, const InferOption& infer_option)
-        : backend_(std::make_unique<TrtBackend>(trt_engine_file, infer_option)) {
+    explicit BaseModel(const std::string& model_file, const InferOption& infer_option)
+        : backend_(createBackend(model_file, infer_option)) {
         if (backend_->option.enable_performance_report) {
-            infer_gpu_trace_ = std::make_unique<GpuTimer>(backend_->stream);
-            infer_cpu_trace_ = std::make_unique<CpuTimer>();
+            // CPU 后端没有 CUDA 流，不创建 GPU 计时器
+            if (backend_->stream) infer_gpu_trace_ = std::make_unique<GpuTimer>(backend_->stream);
+            infer_cpu_trace_   = std::make_unique<CpuTimer>();
+            postprocess_trace_ = std::make_unique<CpuTimer>();
         }
     }
 
@@ -73,6 +75,26 @@ public:
      */
     std::vector<ResultType> predict(const std::vector<Image>& images);
 
+    /**
+     * @brief 对单张图像进行推理，结果写入调用方持有的对象
+     *
+     * result 原有内容被覆盖，其内部容器的容量被复用，逐帧调用时不再分配内存。
+     *
+     * @param image 输入图像
+     * @param result 推理结果
+     */
+    void predict(const Image& image, ResultType& result);
+
+    /**
+     * @brief 对多张图像进行推理，结果写入调用方持有的向量
+     *
+     * results 调整为与 images 等长，已有元素的容量被复用。
+     *
+     * @param images 输入图像向量
+     * @param results 推理结果向量
+     */
+    void predict(const std::vector<Image>& images, std::vector<ResultType>& results);
+
     /**
      * @brief 获取性能报告
      *
@@ -80,6 +102,15 @@ public:
      */
     std::tuple<std::string, std::string, std::string> performanceReport();
 
+    /**
+     * @brief 获取结构化的性能报告，包含端到端延迟与预处理、推理、输出拷贝、后处理各阶段延迟
+     *
+     * 与 performanceReport 相同，读取后清空已累计的统计；未启用性能报告时返回空报告。
+     *
+     * @return 性能报告
+     */
+    PerformanceReport getPerformanceReport();
+
     /**
      * @brief 获取批量大小
      *
@@ -89,18 +120,39 @@ public:
 
 protected:
     /**
-     * @brief 后处理方法，由派生类实现
+     * @brief 后处理方法，按结果类型特化
      *
      * @param idx 索引
-     * @return 后处理后的结果
+     * @param result 后处理结果，原有内容被覆盖，容量复用
+     */
+    void postProcess(int idx, ResultType& result);
+
+    /**
+     * @brief 启用性能报告时开始计时并累计请求数
+     *
+     * @param num_images 本次推理的图像数
+     */
+    void startTrace(size_t num_images);
+
+    /**
+     * @brief 启用性能报告时开始后处理计时
+     *
+     */
+    void startPostprocessTrace();
+
+    /**
+     * @brief 启用性能报告时停止计时
+     *
      */
-    ResultType postProcess(int idx);
+    void stopTrace();
 
-    std::unique_ptr<TrtBackend> backend_;         // < TensorRT 后端
+    std::unique_ptr<BaseBackend> backend_;        // < 推理后端（TensorRT 或 ONNX Runtime CPU）
 
     unsigned long long        total_request_{0};  // < 总请求数
     std::unique_ptr<GpuTimer> infer_gpu_trace_;   // < GPU推理计时器
     std::unique_ptr<CpuTimer> infer_cpu_trace_;   // < CPU推理计时器
+    std::unique_ptr<CpuTimer> postprocess_trace_; // < 后处理计时器
+    std::vector<Image>        single_input_;      // < 单张推理复用的输入向量
 };
 
 // 实例化模板类
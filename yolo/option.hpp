@@ -65,17 +65,50 @@ struct ProcessConfig {
     }
 };
 
+/**
+ * @brief 推理后端类型
+ *
+ */
+enum class InferBackend {
+    TensorRT,        // < TensorRT 引擎（.engine），GPU 推理
+    OnnxRuntimeCPU   // < ONNX Runtime CPU（.onnx），无 GPU 环境推理
+};
+
 /**
  * @brief 推理选项配置结构体
  *
  */
 struct DEPLOYAPI InferOption {
+    InferBackend        backend                   = InferBackend::TensorRT;  // < 推理后端
+    int                 cpu_threads               = 0;      // < CPU 后端推理与预处理线程数，0 表示由 ONNX Runtime / 硬件线程数决定
     int                 device_id                 = 0;      // < GPU ID
     bool                cuda_mem                  = false;  // < 推理数据是否已经在 CUDA 显存中
     bool                enable_managed_memory     = false;  // < 是否启用统一内存
     bool                enable_performance_report = false;  // < 是否启用性能报告
     std::optional<int2> input_shape;                        // < 输入数据的高、宽，未设置时表示宽度可变（用于输入数据宽高确定的任务场景：监控视频分析，AI外挂等）
     ProcessConfig       config;                             // < 图像预处理配置
+    float               score_threshold           = 0.25f;  // < 原始输出头（无 NMS 插件）解码的置信度阈值
+    float               iou_threshold             = 0.45f;  // < 原始输出头解码的 NMS IoU 阈值
+    int                 max_detections            = 300;    // < 原始输出头解码保留的最大目标数
+    bool                class_agnostic_nms        = false;  // < 原始输出头解码时是否跨类别做 NMS
+
+    /**
+     * @brief 设置推理后端
+     *
+     * @param type 后端类型
+     */
+    void setBackend(InferBackend type) {
+        backend = type;
+    }
+
+    /**
+     * @brief 设置 CPU 后端推理线程数
+     *
+     * @param threads 线程数，0 表示由 ONNX Runtime 决定
+     */
+    void setCpuThreads(int threads) {
+        cpu_threads = threads;
+    }
 
     /**
      * @brief 设置 GPU 设备 ID
@@ -138,6 +171,27 @@ struct DEPLOYAPI InferOption {
         config.setNormalizeParams(mean, std);
     }
 
+    /**
+     * @brief 设置原始输出头的解码参数，仅对不含 EfficientNMS 插件的模型生效
+     *
+     * @param score 置信度阈值
+     * @param iou NMS IoU 阈值
+     * @param max_det 保留的最大目标数
+     */
+    void setDecodeParams(float score, float iou, int max_det) {
+        score_threshold = score;
+        iou_threshold   = iou;
+        max_detections  = max_det;
+    }
+
+    /**
+     * @brief 原始输出头解码时跨类别做 NMS
+     *
+     */
+    void enableClassAgnosticNms() {
+        class_agnostic_nms = true;
+    }
+
     /**
      * @brief 设置输入数据的宽高，未设置时表示宽高可变。（用于输入数据宽高确定的任务场景：监控视频分析，AI外挂等）
      *
@@ -142,8 +142,14 @@ void binding_result_module(py::module& m) {
 void binding_option_module(py::module& m) {
     m.doc() = "Option module of TensorRT-YOLO, providing options to configure inference settings.";
 
+    py::enum_<deploy::InferBackend>(m, "InferBackend", "Inference backend type.")
+        .value("TensorRT", deploy::InferBackend::TensorRT)
+        .value("OnnxRuntimeCPU", deploy::InferBackend::OnnxRuntimeCPU);
+
     py::class_<deploy::InferOption>(m, "InferOption", "A class to configure inference options, including device settings, memory options, and image preprocessing.")
         .def(py::init<>())
+        .def("set_backend", &deploy::InferOption::setBackend, "Set the inference backend (TensorRT or OnnxRuntimeCPU).")
+        .def("set_cpu_threads", &deploy::InferOption::setCpuThreads, "Set the number of threads used by the CPU backend.")
         .def("set_device_id", &deploy::InferOption::setDeviceId, "Set the device ID (GPU) for inference.")
         .def("enable_cuda_memory", &deploy::InferOption::enableCudaMem, "Inference data already in CUDA memory.")
         .def("enable_managed_memory", &deploy::InferOption::enableManagedMemory, "Enable managed memory for inference.")
@@ -151,7 +157,9 @@ void binding_option_module(py::module& m) {
         .def("enable_swap_rb", &deploy::InferOption::enableSwapRB, "Enable RGB-to-BGR swap for image input.")
         .def("set_border_value", &deploy::InferOption::setBorderValue, "Set border value for image resizing (used for padding).")
         .def("set_normalize_params", &deploy::InferOption::setNormalizeParams, "Set normalization parameters for image preprocessing.")
-        .def("set_input_dimensions", &deploy::InferOption::setInputDimensions, "Set the input dimensions (height, width) for the model.");
+        .def("set_input_dimensions", &deploy::InferOption::setInputDimensions, "Set the input dimensions (height, width) for the model.")
+        .def("set_decode_params", &deploy::InferOption::setDecodeParams, "Set score threshold, IoU threshold and max detections for models exported without an NMS plugin.")
+        .def("enable_class_agnostic_nms", &deploy::InferOption::enableClassAgnosticNms, "Run NMS across classes when decoding raw detection heads.");
 }
 
 /**
@@ -205,6 +213,7 @@ void bind_model(py::module& m, const std::string& model_name) {
         .def("performance_report", [](ModelType& self) {
             auto report = self.performanceReport();
             return std::make_tuple(py::str(std::get<0>(report)), py::str(std::get<1>(report)), py::str(std::get<2>(report))); }, "Get the performance report of the model.")
+        .def("get_performance_report", &ModelType::getPerformanceReport, "Get the structured performance report with per-stage latencies, then reset the statistics.")
         .def("batch_size", &ModelType::batch_size, "Get the batch size of the model.");
 }
 
@@ -216,6 +225,25 @@ void bind_model(py::module& m, const std::string& model_name) {
 void binding_model_module(py::module& m) {
     m.doc() = "Python bindings for model.hpp, including classes like ClassifyModel, DetectModel, OBBModel, etc.";
 
+    py::class_<deploy::PerformanceResult>(m, "PerformanceResult", "Latency statistics in milliseconds for one stage.")
+        .def_readonly("count", &deploy::PerformanceResult::count, "Number of samples; other fields are zero when it is 0.")
+        .def_readonly("min", &deploy::PerformanceResult::min, "Minimum latency.")
+        .def_readonly("max", &deploy::PerformanceResult::max, "Maximum latency.")
+        .def_readonly("mean", &deploy::PerformanceResult::mean, "Mean latency.")
+        .def_readonly("median", &deploy::PerformanceResult::median, "Median latency.")
+        .def_readonly("percentiles", &deploy::PerformanceResult::percentiles, "Latencies at the percentiles listed in PerformanceReport.percentiles.");
+
+    py::class_<deploy::PerformanceReport>(m, "PerformanceReport", "Performance report with end-to-end and per-stage latencies.")
+        .def_readonly("requests", &deploy::PerformanceReport::requests, "Number of images processed.")
+        .def_readonly("throughput", &deploy::PerformanceReport::throughput, "Throughput in queries per second.")
+        .def_readonly("percentiles", &deploy::PerformanceReport::percentiles, "Percentiles reported by each PerformanceResult.")
+        .def_readonly("cpu", &deploy::PerformanceReport::cpu, "End-to-end CPU latency.")
+        .def_readonly("gpu", &deploy::PerformanceReport::gpu, "End-to-end GPU latency, None for the CPU backend.")
+        .def_readonly("preprocess", &deploy::PerformanceReport::preprocess, "Preprocess latency.")
+        .def_readonly("inference", &deploy::PerformanceReport::inference, "Inference latency.")
+        .def_readonly("output_copy", &deploy::PerformanceReport::output_copy, "Output copy latency.")
+        .def_readonly("postprocess", &deploy::PerformanceReport::postprocess, "Postprocess latency.");
+
     bind_model<deploy::ClassifyModel>(m, "ClassifyModel");
     bind_model<deploy::DetectModel>(m, "DetectModel");
     bind_model<deploy::OBBModel>(m, "OBBModel");
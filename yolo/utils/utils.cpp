@@ -8,7 +8,13 @@
  *
  */
 #include <algorithm>
+#include <cmath>
 #include <fstream>
+#include <stdexcept>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 #include "yolo/core/macro.hpp"
 #include "yolo/utils/utils.hpp"
@@ -41,6 +47,26 @@ bool SupportsIntegratedZeroCopy(const int gpu_id) {
     }
 }
 
+bool SupportsAvx2() {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx     = (info[2] & (1 << 28)) != 0;
+    // 操作系统需保存 YMM 寄存器状态
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#elif defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
 float findPercentile(float percentile, std::vector<float> const& timings) {
     int32_t const all     = static_cast<int32_t>(timings.size());
     int32_t const exclude = static_cast<int32_t>((1 - percentile / 100) * all);
@@ -73,6 +99,7 @@ PerformanceResult getPerformanceResult(std::vector<float> const& timings, std::v
     std::vector<float> newTimings = timings;
     std::sort(newTimings.begin(), newTimings.end(), metricComparator);
     PerformanceResult result;
+    result.count  = newTimings.size();
     result.min    = newTimings.front();
     result.max    = newTimings.back();
     result.mean   = std::accumulate(newTimings.begin(), newTimings.end(), 0.0F, metricAccumulator) / newTimings.size();
@@ -83,13 +110,98 @@ PerformanceResult getPerformanceResult(std::vector<float> const& timings, std::v
     return result;
 }
 
+int LatencyHistogram::bucketIndex(uint64_t us) noexcept {
+    if (us < static_cast<uint64_t>(kSubBucketCount)) return static_cast<int>(us);
+
+    // 最高位决定倍程，其后 kSubBucketBits 位决定子桶
+#if defined(_MSC_VER)
+    unsigned long msb;
+    _BitScanReverse64(&msb, us);
+#else
+    int msb = 63 - __builtin_clzll(us);
+#endif
+    int exponent = static_cast<int>(msb) - kSubBucketBits;
+    if (exponent > kMaxExponent) return kBucketCount - 1;
+    int sub = static_cast<int>(us >> exponent) - kSubBucketCount;
+    return (exponent + 1) * kSubBucketCount + sub;
+}
+
+double LatencyHistogram::bucketMidpoint(int index) noexcept {
+    if (index < kSubBucketCount) return index;
+    int      exponent = index / kSubBucketCount - 1;
+    uint64_t lower    = static_cast<uint64_t>(kSubBucketCount + index % kSubBucketCount) << exponent;
+    return lower + ((uint64_t{1} << exponent) - 1) * 0.5;
+}
+
+void LatencyHistogram::record(float ms) noexcept {
+    if (!(ms > 0.0F)) ms = 0.0F;
+    // 四舍五入后经 uint64_t 转换，上限留在 2^64 以内，避免 llround 超出 long long 的未定义行为
+    double us = std::min(static_cast<double>(ms) * 1000.0, 1.8e19);
+    ++counts_[bucketIndex(static_cast<uint64_t>(us + 0.5))];
+    ++count_;
+    sum_ += ms;
+    min_ = std::min(min_, ms);
+    max_ = std::max(max_, ms);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) noexcept {
+    for (int i = 0; i < kBucketCount; ++i) counts_[i] += other.counts_[i];
+    count_ += other.count_;
+    sum_ += other.sum_;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+}
+
+void LatencyHistogram::reset() noexcept {
+    counts_.fill(0);
+    count_ = 0;
+    sum_   = 0.0;
+    min_   = std::numeric_limits<float>::max();
+    max_   = 0.0F;
+}
+
+float LatencyHistogram::percentile(float percentile) const {
+    if (percentile < 0.F || percentile > 100.F) {
+        throw std::runtime_error("percentile is not in [0, 100]!");
+    }
+    if (count_ == 0) return 0.0F;
+    if (percentile == 0.F) return min_;
+    if (percentile == 100.F) return max_;
+
+    // 第 rank 个样本（从 1 计）所在的桶
+    uint64_t rank = static_cast<uint64_t>(std::ceil(percentile / 100.0 * count_));
+    rank          = std::max<uint64_t>(rank, 1);
+    uint64_t seen = 0;
+    for (int i = 0; i < kBucketCount; ++i) {
+        seen += counts_[i];
+        if (seen >= rank) {
+            float ms = static_cast<float>(bucketMidpoint(i) / 1000.0);
+            return std::min(std::max(ms, min_), max_);
+        }
+    }
+    return max_;
+}
+
+PerformanceResult getPerformanceResult(const LatencyHistogram& histogram, std::vector<float> const& percentiles) {
+    PerformanceResult result;
+    result.count  = histogram.count();
+    result.min    = histogram.min();
+    result.max    = histogram.max();
+    result.mean   = histogram.mean();
+    result.median = histogram.percentile(50.F);
+    for (auto percentile : percentiles) {
+        result.percentiles.emplace_back(histogram.percentile(percentile));
+    }
+    return result;
+}
+
 void CpuTimer::start() {
     mStart = std::chrono::high_resolution_clock::now();
 }
 
 void CpuTimer::stop() {
     mStop = std::chrono::high_resolution_clock::now();
-    mMs.push_back(std::chrono::duration<float, std::milli>{mStop - mStart}.count());
+    mHistogram.record(std::chrono::duration<float, std::milli>{mStop - mStart}.count());
 }
 
 GpuTimer::GpuTimer(cudaStream_t stream) : mStream(stream) {
@@ -111,7 +223,7 @@ void GpuTimer::stop() {
     CHECK(cudaEventSynchronize(mStop));
     float ms{0.0F};
     CHECK(cudaEventElapsedTime(&ms, mStart, mStop));
-    mMs.push_back(ms);
+    mHistogram.record(ms);
 }
 
 }  // namespace deploy
@@ -12,8 +12,12 @@
 
 #include <cuda_runtime_api.h>
 
+#include <array>
 #include <chrono>
+#include <cstdint>
+#include <limits>
 #include <numeric>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -44,6 +48,16 @@ void ReadBinaryFromFile(const std::string& file, std::string* contents);
  */
 bool SupportsIntegratedZeroCopy(const int gpu_id);
 
+/**
+ * @brief 检查当前 CPU 与操作系统是否支持 AVX2 指令集
+ *
+ * 供 CPU 预处理与后处理在运行时选择 SIMD 实现，非 x86 平台返回 `false`。
+ *
+ * @return true 如果支持 AVX2
+ * @return false 如果不支持 AVX2
+ */
+bool SupportsAvx2();
+
 /**
  * @brief 在一个升序的时间序列中找到指定的百分位数
  * @note 百分位数必须在 [0, 100] 范围内。否则，将抛出异常。
@@ -67,6 +81,7 @@ float findMedian(std::vector<float> const& timings);
  * @brief 性能指标的性能结果
  */
 struct PerformanceResult {
+    uint64_t           count{0};     // < 样本数，为 0 时其余字段无意义
     float              min{0.f};     // < 最小值
     float              max{0.f};     // < 最大值
     float              mean{0.f};    // < 平均值
@@ -83,28 +98,144 @@ struct PerformanceResult {
  */
 PerformanceResult getPerformanceResult(std::vector<float> const& timings, std::vector<float> const& percentiles);
 
+/**
+ * @brief 定长的对数-线性延迟直方图
+ *
+ * 以微秒为单位记录延迟：小于 128 us 时每个桶 1 us，此后每个 2 的倍程等分为 128 个子桶，
+ * 相对误差不超过 1/128，覆盖到 2^32 us（约 71 分钟），更大的值计入最后一个桶。
+ * 记录为 O(1)，内存固定，不保存原始样本；不同线程或实例的直方图可以合并后统一统计。
+ * 本身不加锁，每个线程记录自己的直方图，需要时再合并。
+ */
+class DEPLOYAPI LatencyHistogram {
+public:
+    static constexpr int kSubBucketBits  = 7;                                       // < 每个倍程的子桶位数
+    static constexpr int kSubBucketCount = 1 << kSubBucketBits;                     // < 每个倍程的子桶数
+    static constexpr int kMaxExponent    = 32 - kSubBucketBits;                     // < 最大倍程，覆盖到 2^32 us
+    static constexpr int kBucketCount    = (kMaxExponent + 1) * kSubBucketCount + kSubBucketCount;  // < 桶总数
+
+    /**
+     * @brief 记录一次延迟
+     *
+     * @param ms 延迟（毫秒），负值按 0 记录
+     */
+    void record(float ms) noexcept;
+
+    /**
+     * @brief 合并另一个直方图的全部样本
+     *
+     * @param other 另一个直方图
+     */
+    void merge(const LatencyHistogram& other) noexcept;
+
+    /**
+     * @brief 清空全部样本
+     *
+     */
+    void reset() noexcept;
+
+    /**
+     * @brief 估计指定百分位数的延迟
+     * @note 百分位数必须在 [0, 100] 范围内，否则抛出异常；0 和 100 分别返回精确的最小值和最大值。
+     *
+     * @param percentile 百分位数
+     * @return float 延迟（毫秒），取所在桶的中点；无样本时返回 0
+     */
+    float percentile(float percentile) const;
+
+    uint64_t count() const noexcept {
+        return count_;
+    }  // < 样本数
+    double sumMilliseconds() const noexcept {
+        return sum_;
+    }  // < 延迟总和（毫秒）
+    float min() const noexcept {
+        return count_ ? min_ : 0.0F;
+    }  // < 最小延迟（毫秒）
+    float max() const noexcept {
+        return count_ ? max_ : 0.0F;
+    }  // < 最大延迟（毫秒）
+    float mean() const noexcept {
+        return count_ ? static_cast<float>(sum_ / count_) : 0.0F;
+    }  // < 平均延迟（毫秒）
+
+private:
+    static int    bucketIndex(uint64_t us) noexcept;   // < 微秒值所在的桶
+    static double bucketMidpoint(int index) noexcept;  // < 桶中点（微秒）
+
+    std::array<uint64_t, kBucketCount> counts_{};                                // < 各桶计数
+    uint64_t                           count_ = 0;                               // < 样本数
+    double                             sum_   = 0.0;                             // < 延迟总和（毫秒）
+    float                              min_   = std::numeric_limits<float>::max();  // < 最小延迟（毫秒）
+    float                              max_   = 0.0F;                            // < 最大延迟（毫秒）
+};
+
+/**
+ * @brief 从延迟直方图获取性能结果对象，耗时与样本数无关
+ *
+ * @param histogram 延迟直方图
+ * @param percentiles 百分位数列表，取值范围 [0, 100]
+ * @return PerformanceResult 性能结果对象
+ */
+DEPLOYAPI PerformanceResult getPerformanceResult(const LatencyHistogram& histogram, std::vector<float> const& percentiles);
+
+/**
+ * @brief 推理后端内各阶段的耗时直方图，仅在启用性能报告时记录
+ *
+ * ONNX Runtime 后端按 CPU 时间分别统计三个阶段；TensorRT 动态形状按 CUDA 事件统计，
+ * 预处理包含主机端输入拷贝；TensorRT 静态形状的拷贝、仿射变换、推理和输出拷贝在同一个 CUDA 图中执行，
+ * 整体计入推理，预处理只包含主机端输入拷贝和图节点参数更新，输出拷贝没有样本。
+ */
+struct StageTimes {
+    LatencyHistogram preprocess;   // < 预处理：输入拷贝与仿射变换
+    LatencyHistogram inference;    // < 推理
+    LatencyHistogram output_copy;  // < 输出张量拷贝到主机
+
+    void reset() noexcept {
+        preprocess.reset();
+        inference.reset();
+        output_copy.reset();
+    }  // < 清空全部阶段
+};
+
+/**
+ * @brief 结构化的性能报告，各阶段延迟单位为毫秒
+ *
+ */
+struct PerformanceReport {
+    uint64_t                         requests{0};      // < 统计期间的请求图像数
+    float                            throughput{0.f};  // < 吞吐量（qps）
+    std::vector<float>               percentiles;      // < 各结果中 percentiles 对应的百分位数
+    PerformanceResult                cpu;              // < 端到端 CPU 延迟
+    std::optional<PerformanceResult> gpu;              // < 端到端 GPU 延迟，CPU 后端为空
+    PerformanceResult                preprocess;       // < 预处理
+    PerformanceResult                inference;        // < 推理
+    PerformanceResult                output_copy;      // < 输出拷贝
+    PerformanceResult                postprocess;      // < 后处理
+};
+
 /**
  * @brief 定义一个计时器基类
  *
- * 该类提供了基本的计时功能，包括开始计时、停止计时、获取计时结果（毫秒）、重置计时结果以及获取总计时（毫秒）。
+ * 该类提供了基本的计时功能，包括开始计时、停止计时、获取计时结果、重置计时结果以及获取总计时（毫秒）。
+ * 计时结果记录在定长的延迟直方图中，长时间运行内存不增长。
  * 它是一个抽象类，用于派生出具体的 CPU 计时器和 GPU 计时器类。
  */
 class TimerBase {
 public:
-    virtual void       start() {}  // < 虚函数，用于开始计时
-    virtual void       stop() {}   // < 虚函数，用于停止计时
-    std::vector<float> milliseconds() const noexcept {
-        return mMs;
-    }  // < 获取计时结果（毫秒）
+    virtual void            start() {}  // < 虚函数，用于开始计时
+    virtual void            stop() {}   // < 虚函数，用于停止计时
+    const LatencyHistogram& histogram() const noexcept {
+        return mHistogram;
+    }  // < 获取计时结果的延迟直方图
     void reset() noexcept {
-        mMs.clear();
+        mHistogram.reset();
     }  // < 重置计时结果
     float totalMilliseconds() const noexcept {
-        return std::accumulate(mMs.begin(), mMs.end(), 0.0F);
+        return static_cast<float>(mHistogram.sumMilliseconds());
     }  // < 获取总计时（毫秒）
 
 protected:
-    std::vector<float> mMs;  // < 计时结果列表
+    LatencyHistogram mHistogram;  // < 计时结果直方图
 };
 
 /**